@@ -13,6 +13,7 @@ CXX_SRCS :=
 C++_SRCS := 
 CC_SRCS := 
 OBJS := 
+TOOLS_OBJS := 
 C++_DEPS := 
 C_DEPS := 
 CC_DEPS := 
@@ -24,4 +25,5 @@ C_UPPER_DEPS :=
 # Every subdirectory with source files must be described here
 SUBDIRS := \
 src \
+tools \
 
@@ -4,16 +4,88 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/batchspectrum.cpp \
+../src/checksum.cpp \
+../src/dataset.cpp \
+../src/descriptor.cpp \
+../src/extraction.cpp \
+../src/fastspectrum.cpp \
+../src/journal.cpp \
+../src/kernels.cpp \
+../src/kernels_avx2.cpp \
+../src/kernels_avx512.cpp \
+../src/kernels_sse42.cpp \
+../src/keyframes.cpp \
+../src/parameters.cpp \
+../src/pls.cpp \
+../src/rawvideo.cpp \
+../src/recursivegaussian.cpp \
+../src/resultcache.cpp \
+../src/rhythmwriter.cpp \
+../src/rowstatistics.cpp \
+../src/scheduler.cpp \
+../src/scorer.cpp \
+../src/server.cpp \
+../src/threadpool.cpp \
+../src/tracer.cpp \
 ../src/visualrhythm.cpp \
 ../src/main.cpp \
 ../src/video.cpp 
 
 OBJS += \
+./src/batchspectrum.o \
+./src/checksum.o \
+./src/dataset.o \
+./src/descriptor.o \
+./src/extraction.o \
+./src/fastspectrum.o \
+./src/journal.o \
+./src/kernels.o \
+./src/kernels_avx2.o \
+./src/kernels_avx512.o \
+./src/kernels_sse42.o \
+./src/keyframes.o \
+./src/parameters.o \
+./src/pls.o \
+./src/rawvideo.o \
+./src/recursivegaussian.o \
+./src/resultcache.o \
+./src/rhythmwriter.o \
+./src/rowstatistics.o \
+./src/scheduler.o \
+./src/scorer.o \
+./src/server.o \
+./src/threadpool.o \
+./src/tracer.o \
 ./src/visualrhythm.o \
 ./src/main.o \
 ./src/video.o 
 
 CPP_DEPS += \
+./src/batchspectrum.d \
+./src/checksum.d \
+./src/dataset.d \
+./src/descriptor.d \
+./src/extraction.d \
+./src/fastspectrum.d \
+./src/journal.d \
+./src/kernels.d \
+./src/kernels_avx2.d \
+./src/kernels_avx512.d \
+./src/kernels_sse42.d \
+./src/keyframes.d \
+./src/parameters.d \
+./src/pls.d \
+./src/rawvideo.d \
+./src/recursivegaussian.d \
+./src/resultcache.d \
+./src/rhythmwriter.d \
+./src/rowstatistics.d \
+./src/scheduler.d \
+./src/scorer.d \
+./src/server.d \
+./src/threadpool.d \
+./src/tracer.d \
 ./src/visualrhythm.d \
 ./src/main.d \
 ./src/video.d 
@@ -23,8 +95,63 @@ CPP_DEPS += \
 src/%.o: ../src/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: GCC C++ Compiler'
-	g++ $(OPENCVFLAGS) -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
 
+
+# The kernels are optimized, and each instruction set level is built with the flags of the level
+KERNEL_FLAGS := -O3
+
+src/kernels.o: ../src/kernels.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread $(KERNEL_FLAGS) -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+# The transforms of the batched spectra, the recursive gaussian and the products of the partial
+# least squares are optimized as the kernels
+src/pls.o: ../src/pls.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread $(KERNEL_FLAGS) -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+src/batchspectrum.o: ../src/batchspectrum.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread $(KERNEL_FLAGS) -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+src/recursivegaussian.o: ../src/recursivegaussian.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread $(KERNEL_FLAGS) -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+src/kernels_sse42.o: ../src/kernels_sse42.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread $(KERNEL_FLAGS) -msse4.2 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+src/kernels_avx2.o: ../src/kernels_avx2.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread $(KERNEL_FLAGS) -mavx2 -mfma -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+src/kernels_avx512.o: ../src/kernels_avx512.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -std=c++11 -pthread $(KERNEL_FLAGS) -mavx512f -mavx512bw -mavx2 -mfma -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
@@ -0,0 +1,45 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../tools/client.cpp \
+../tools/loadtest.cpp \
+../tools/validate.cpp \
+../tools/transpose.cpp \
+../tools/merge.cpp \
+../tools/synth.cpp \
+../tools/benchmark.cpp \
+../tools/train.cpp 
+
+TOOLS_OBJS += \
+./tools/client.o \
+./tools/loadtest.o \
+./tools/validate.o \
+./tools/transpose.o \
+./tools/merge.o \
+./tools/synth.o \
+./tools/benchmark.o \
+./tools/train.o 
+
+CPP_DEPS += \
+./tools/client.d \
+./tools/loadtest.d \
+./tools/validate.d \
+./tools/transpose.d \
+./tools/merge.d \
+./tools/synth.d \
+./tools/benchmark.d \
+./tools/train.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+tools/%.o: ../tools/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: GCC C++ Compiler'
+	g++ $(OPENCVFLAGS) -I../src -std=c++11 -pthread -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
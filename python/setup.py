@@ -0,0 +1,68 @@
+# Build of the Python module of the visual rhythm extraction:
+#
+#     cd python && python setup.py build_ext --inplace
+#
+# It requires NumPy and OpenCV 2.4 (found by pkg-config). The sources of src/ are compiled into
+# the module, except main.cpp; the kernels of each instruction set level are compiled with the
+# flags of the level, as in Release/src/subdir.mk.
+
+import glob
+import os
+import subprocess
+
+import numpy
+from setuptools import Extension, setup
+from setuptools.command.build_ext import build_ext
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SRC = os.path.join(HERE, '..', 'src')
+
+KERNEL_FLAGS = {
+    'kernels.cpp': [],
+    'kernels_sse42.cpp': ['-msse4.2'],
+    'kernels_avx2.cpp': ['-mavx2', '-mfma'],
+    'kernels_avx512.cpp': ['-mavx512f', '-mavx512bw', '-mavx2', '-mfma'],
+}
+
+COMPILE_FLAGS = ['-std=c++11', '-pthread', '-O2']
+
+
+def pkg_config(*options):
+    output = subprocess.check_output(['pkg-config'] + list(options) + ['opencv'])
+    return output.decode().split()
+
+
+class BuildExt(build_ext):
+    """Compiles the kernels with the flags of their levels before the rest of the module."""
+
+    def build_extension(self, ext):
+        objects = []
+        for name in sorted(KERNEL_FLAGS):
+            objects += self.compiler.compile([os.path.join(SRC, name)],
+                                             output_dir=self.build_temp,
+                                             include_dirs=ext.include_dirs,
+                                             extra_postargs=COMPILE_FLAGS + ['-O3'] +
+                                             KERNEL_FLAGS[name])
+        ext.extra_objects = objects + ext.extra_objects
+        build_ext.build_extension(self, ext)
+
+
+sources = [os.path.join(HERE, 'visualrhythmmodule.cpp')]
+sources += [path for path in sorted(glob.glob(os.path.join(SRC, '*.cpp')))
+            if os.path.basename(path) != 'main.cpp' and
+            os.path.basename(path) not in KERNEL_FLAGS]
+
+module = Extension('visualrhythm',
+                   sources=sources,
+                   include_dirs=[SRC, numpy.get_include()] +
+                   [flag[2:] for flag in pkg_config('--cflags-only-I')],
+                   extra_compile_args=COMPILE_FLAGS + pkg_config('--cflags-only-other'),
+                   extra_link_args=['-pthread'] + pkg_config('--libs'),
+                   language='c++')
+
+setup(name='visualrhythm',
+      version='1.0',
+      description='Extraction of visual rhythms for the detection of video-based facial spoof '
+                  'attacks',
+      ext_modules=[module],
+      cmdclass={'build_ext': BuildExt})
@@ -0,0 +1,362 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Python module wrapping the extraction of visual rhythms. The visual rhythms and spectra are
+// returned as NumPy arrays that share the buffers computed in C++, and the interpreter lock is
+// released while the frames are processed, so several Python threads may extract at once.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#include "extraction.h"
+#include "kernels.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+// Name of the capsules keeping the buffers of the arrays
+#define MAT_CAPSULE_NAME "visualrhythm.Mat"
+
+// To release the Mat whose buffer was shared with an array
+static void release_mat(PyObject *capsule) {
+    delete static_cast<Mat*>(PyCapsule_GetPointer(capsule, MAT_CAPSULE_NAME));
+}
+
+// To wrap a Mat in an array sharing its buffer. With frame_number > 0 the rows are split in
+// frame_number blocks, giving an array of shape (frame_number, rows / frame_number, cols).
+static PyObject *wrap_mat(const Mat &mat, int frame_number) {
+    npy_intp dims[3] = { 0, 0, 0 };
+    npy_intp strides[3] = { 0, 0, 0 };
+    int nd = (frame_number > 0) ? 3 : 2;
+
+    if (mat.empty() || (frame_number > 0 && mat.rows % frame_number != 0)) {
+        return PyArray_ZEROS(nd, dims, NPY_UINT8, 0);
+    }
+
+    if (frame_number > 0) {
+        dims[0] = frame_number;
+        dims[1] = mat.rows / frame_number;
+        dims[2] = mat.cols;
+        strides[0] = static_cast<npy_intp>(mat.step) * dims[1];
+        strides[1] = static_cast<npy_intp>(mat.step);
+        strides[2] = 1;
+    } else {
+        dims[0] = mat.rows;
+        dims[1] = mat.cols;
+        strides[0] = static_cast<npy_intp>(mat.step);
+        strides[1] = 1;
+    }
+
+    // The copy of the header keeps a reference to the buffer until the array is released
+    Mat *owner = new Mat(mat);
+
+    PyObject *array = PyArray_New(&PyArray_Type, nd, dims, NPY_UINT8, strides, owner->data, 0,
+      NPY_ARRAY_ALIGNED | NPY_ARRAY_WRITEABLE, NULL);
+
+    if (array == NULL) {
+        delete owner;
+        return NULL;
+    }
+
+    PyObject *capsule = PyCapsule_New(owner, MAT_CAPSULE_NAME, release_mat);
+
+    if (capsule == NULL) {
+        delete owner;
+        Py_DECREF(array);
+        return NULL;
+    }
+
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array), capsule) < 0) {
+        Py_DECREF(array);
+        return NULL;
+    }
+
+    return array;
+}
+
+// To check the parameters given by keywords, raising ValueError for invalid values. The width of
+// the strips is checked against the width of the frames when it is known (frame_width > 0)
+static bool check_parameters(const Parameters &parameters, int frame_width = 0) {
+
+    if (parameters.visual_rhythm_type < 0 || parameters.visual_rhythm_type > 2) {
+        PyErr_SetString(PyExc_ValueError, "visual_rhythm_type must be 0, 1 or 2");
+        return false;
+    }
+
+    if (parameters.color_space < 0 || parameters.color_space > 1) {
+        PyErr_SetString(PyExc_ValueError, "color_space must be 0 or 1");
+        return false;
+    }
+
+    if (parameters.filter < 0 || parameters.filter > 2) {
+        PyErr_SetString(PyExc_ValueError, "filter must be 0, 1 or 2");
+        return false;
+    }
+
+    if (parameters.kernel_size < 1 || parameters.kernel_size % 2 == 0) {
+        PyErr_SetString(PyExc_ValueError, "kernel_size must be a positive odd integer");
+        return false;
+    }
+
+    if (parameters.frame_number < 1 || parameters.roi_width < 1 || parameters.threads < 1) {
+        PyErr_SetString(PyExc_ValueError,
+          "frame_number, roi_width and threads must be positive integers");
+        return false;
+    }
+
+    if (frame_width > 0 && parameters.roi_width > frame_width) {
+        PyErr_SetString(PyExc_ValueError, "roi_width must not be larger than the frames");
+        return false;
+    }
+
+    return true;
+}
+
+// To compute the visual rhythm of the input (opened if is_opened, otherwise input_video) and
+// return it, together with the spectra of the frames if keep_spectra
+static PyObject *run_extraction(const Parameters &parameters, Video &processor, bool is_opened,
+  bool keep_spectra) {
+
+    // A new object for each call, because its buffers are given to the arrays
+    VisualRhythm visual_rhythm;
+    ThreadPool thread_pool;
+    bool is_done = false;
+    bool is_thrown = false;
+    string error = "";
+
+    Py_BEGIN_ALLOW_THREADS
+
+    thread_pool.start(parameters.threads);
+    visual_rhythm.set_thread_pool(&thread_pool);
+    visual_rhythm.set_spectrum_number(keep_spectra ? parameters.frame_number : 0);
+
+    // An exception must not cross the interpreter, which holds no lock here
+    try {
+        if (is_opened) {
+            is_done = extract_opened_visual_rhythm(parameters, processor, visual_rhythm);
+        } else {
+            is_done = extract_visual_rhythm(parameters, processor, visual_rhythm);
+        }
+    } catch (const cv::Exception &exception) {
+        is_thrown = true;
+        error = exception.err;
+    } catch (const std::exception &exception) {
+        is_thrown = true;
+        error = exception.what();
+    }
+
+    Py_END_ALLOW_THREADS
+
+    if (is_thrown) {
+        PyErr_Format(PyExc_RuntimeError, "Could not compute the visual rhythm of %s: %s",
+          parameters.input_video.c_str(), error.c_str());
+        return NULL;
+    }
+
+    if (!is_done) {
+        PyErr_Format(PyExc_IOError, "Could not compute the visual rhythm of %s",
+          parameters.input_video.c_str());
+        return NULL;
+    }
+
+    // Only the columns of the frames really processed are returned
+    Mat rhythm = visual_rhythm.get_visual_rhythm();
+    int frame_number = visual_rhythm.get_frame_number();
+    int cols = std::min(frame_number * parameters.roi_width, rhythm.cols);
+
+    PyObject *rhythm_array = wrap_mat(rhythm.colRange(0, cols), 0);
+
+    if (!keep_spectra || rhythm_array == NULL) {
+        return rhythm_array;
+    }
+
+    Mat spectra = visual_rhythm.get_spectra();
+    PyObject *spectra_array = wrap_mat(spectra,
+      std::min(frame_number, parameters.frame_number));
+
+    if (spectra_array == NULL) {
+        Py_DECREF(rhythm_array);
+        return NULL;
+    }
+
+    return Py_BuildValue("(NN)", rhythm_array, spectra_array);
+}
+
+static PyObject *extract(PyObject *self, PyObject *args, PyObject *keywords) {
+    static const char *keyword_list[] = { "input_video", "visual_rhythm_type", "frame_number",
+      "color_space", "filter", "kernel_size", "variance", "roi_width", "threads",
+      "fast_spectrum", "spectra", NULL };
+
+    Parameters parameters;
+    const char *input_video = NULL;
+    int fast_spectrum = 0;
+    int keep_spectra = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywords, "s|iiiiifiipp",
+          const_cast<char**>(keyword_list), &input_video, &parameters.visual_rhythm_type,
+          &parameters.frame_number, &parameters.color_space, &parameters.filter,
+          &parameters.kernel_size, &parameters.variance, &parameters.roi_width,
+          &parameters.threads, &fast_spectrum, &keep_spectra)) {
+        return NULL;
+    }
+
+    parameters.input_video = input_video;
+    parameters.fast_spectrum = fast_spectrum;
+    parameters.verbose = false;
+
+    if (!check_parameters(parameters)) {
+        return NULL;
+    }
+
+    Video processor;
+
+    return run_extraction(parameters, processor, false, keep_spectra != 0);
+}
+
+static PyObject *extract_frames(PyObject *self, PyObject *args, PyObject *keywords) {
+    static const char *keyword_list[] = { "frames", "visual_rhythm_type", "frame_number",
+      "color_space", "filter", "kernel_size", "variance", "roi_width", "threads",
+      "fast_spectrum", "spectra", "frame_rate", NULL };
+
+    Parameters parameters;
+    PyObject *frames_object = NULL;
+    int fast_spectrum = 0;
+    int keep_spectra = 0;
+    double frame_rate = 25.0;
+
+    // All frames by default
+    parameters.frame_number = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywords, "O|iiiiifiippd",
+          const_cast<char**>(keyword_list), &frames_object, &parameters.visual_rhythm_type,
+          &parameters.frame_number, &parameters.color_space, &parameters.filter,
+          &parameters.kernel_size, &parameters.variance, &parameters.roi_width,
+          &parameters.threads, &fast_spectrum, &keep_spectra, &frame_rate)) {
+        return NULL;
+    }
+
+    // A stack of gray frames (n, height, width) or BGR frames (n, height, width, 3), copied
+    // only if it is not a contiguous array of bytes
+    PyArrayObject *array = reinterpret_cast<PyArrayObject*>(PyArray_FROM_OTF(frames_object,
+      NPY_UINT8, NPY_ARRAY_IN_ARRAY));
+
+    if (array == NULL) {
+        return NULL;
+    }
+
+    int nd = PyArray_NDIM(array);
+
+    if (!(nd == 3 || (nd == 4 && PyArray_DIM(array, 3) == 3)) || PyArray_DIM(array, 0) < 1) {
+        Py_DECREF(array);
+        PyErr_SetString(PyExc_ValueError,
+          "frames must have shape (n, height, width) or (n, height, width, 3)");
+        return NULL;
+    }
+
+    int rows = static_cast<int>(PyArray_DIM(array, 1));
+    int cols = static_cast<int>(PyArray_DIM(array, 2));
+    int type = (nd == 3) ? CV_8UC1 : CV_8UC3;
+    vector<Mat> frames;
+
+    for (npy_intp i = 0; i < PyArray_DIM(array, 0); i++) {
+        frames.push_back(Mat(rows, cols, type, PyArray_GETPTR1(array, i),
+          static_cast<size_t>(PyArray_STRIDE(array, 1))));
+    }
+
+    if (parameters.frame_number <= 0) {
+        parameters.frame_number = static_cast<int>(frames.size());
+    }
+
+    parameters.input_video = "frames";
+    parameters.fast_spectrum = fast_spectrum;
+    parameters.verbose = false;
+
+    if (!check_parameters(parameters, cols)) {
+        Py_DECREF(array);
+        return NULL;
+    }
+
+    Video processor;
+    PyObject *result = NULL;
+
+    if (!processor.set_input_frames(frames, frame_rate)) {
+        PyErr_SetString(PyExc_ValueError, "Could not read the frames");
+    } else {
+        result = run_extraction(parameters, processor, true, keep_spectra != 0);
+    }
+
+    // The frames are used without copies, so the array is kept until the extraction is over
+    Py_DECREF(array);
+
+    return result;
+}
+
+static PyObject *kernel_level(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString(get_kernel_level_name(get_kernel_level()).c_str());
+}
+
+static PyMethodDef visualrhythm_methods[] = {
+    { "extract", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(extract)),
+      METH_VARARGS | METH_KEYWORDS,
+      "extract(input_video, visual_rhythm_type=0, frame_number=50, color_space=0, filter=0, "
+      "kernel_size=7, variance=2.0, roi_width=30, threads=1, fast_spectrum=0, spectra=False)\n\n"
+      "Compute the visual rhythm of a video file. Returns the visual rhythm (uint8 array of "
+      "shape (height, roi_width * frames)), or the tuple (rhythm, spectra) with the spectra of "
+      "the frames (shape (frames, height, width)) if spectra is True." },
+    { "extract_frames", reinterpret_cast<PyCFunction>(
+        reinterpret_cast<void(*)(void)>(extract_frames)), METH_VARARGS | METH_KEYWORDS,
+      "extract_frames(frames, visual_rhythm_type=0, frame_number=0, color_space=0, filter=0, "
+      "kernel_size=7, variance=2.0, roi_width=30, threads=1, fast_spectrum=0, spectra=False, "
+      "frame_rate=25.0)\n\n"
+      "Compute the visual rhythm of a stack of uint8 frames, gray (n, height, width) or BGR "
+      "(n, height, width, 3). frame_number=0 uses all frames. Returns the same of extract()." },
+    { "kernel_level", kernel_level, METH_NOARGS,
+      "kernel_level()\n\nName of the instruction set level of the kernels in use." },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef visualrhythm_module = {
+    PyModuleDef_HEAD_INIT,
+    "visualrhythm",
+    "Extraction of visual rhythms for the detection of video-based facial spoof attacks.",
+    -1,
+    visualrhythm_methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_visualrhythm(void) {
+    import_array();
+
+    return PyModule_Create(&visualrhythm_module);
+}
@@ -0,0 +1,523 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "batchspectrum.h"
+#include "fastspectrum.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// The runs read and written by a stage never overlap, which the compiler can not prove for the
+// many pointers of a butterfly, so the loops over the runs are vectorized without alias checks
+#define VECTORIZE_RUN _Pragma("GCC ivdep")
+
+// Stage of radix 2: y[2p + k] = (a0 +- a1) * w^(pk), for runs of n values of all lanes
+static void radix2_stage(const float *xr, const float *xi, float *yr, float *yi, int m,
+  size_t run, const float *twiddles) {
+
+    for (int p = 0; p < m; p++) {
+        const float wr = twiddles[2 * p];
+        const float wi = twiddles[2 * p + 1];
+        const float *ar = xr + p * run, *ai = xi + p * run;
+        const float *br = xr + (p + m) * run, *bi = xi + (p + m) * run;
+        float *y0r = yr + (2 * p) * run, *y0i = yi + (2 * p) * run;
+        float *y1r = yr + (2 * p + 1) * run, *y1i = yi + (2 * p + 1) * run;
+
+        VECTORIZE_RUN
+        for (size_t t = 0; t < run; t++) {
+            float dr = ar[t] - br[t];
+            float di = ai[t] - bi[t];
+
+            y0r[t] = ar[t] + br[t];
+            y0i[t] = ai[t] + bi[t];
+            y1r[t] = dr * wr - di * wi;
+            y1i[t] = dr * wi + di * wr;
+        }
+    }
+}
+
+// Stage of radix 4, with the roots of unity -i, -1 and i applied without multiplications
+static void radix4_stage(const float *xr, const float *xi, float *yr, float *yi, int m,
+  size_t run, const float *twiddles) {
+
+    for (int p = 0; p < m; p++) {
+        const float *w = twiddles + 6 * p;
+        const float *a0r = xr + p * run, *a0i = xi + p * run;
+        const float *a1r = xr + (p + m) * run, *a1i = xi + (p + m) * run;
+        const float *a2r = xr + (p + 2 * m) * run, *a2i = xi + (p + 2 * m) * run;
+        const float *a3r = xr + (p + 3 * m) * run, *a3i = xi + (p + 3 * m) * run;
+        float *y0r = yr + (4 * p) * run, *y0i = yi + (4 * p) * run;
+        float *y1r = yr + (4 * p + 1) * run, *y1i = yi + (4 * p + 1) * run;
+        float *y2r = yr + (4 * p + 2) * run, *y2i = yi + (4 * p + 2) * run;
+        float *y3r = yr + (4 * p + 3) * run, *y3i = yi + (4 * p + 3) * run;
+
+        VECTORIZE_RUN
+        for (size_t t = 0; t < run; t++) {
+            float t0r = a0r[t] + a2r[t], t0i = a0i[t] + a2i[t];
+            float t1r = a0r[t] - a2r[t], t1i = a0i[t] - a2i[t];
+            float t2r = a1r[t] + a3r[t], t2i = a1i[t] + a3i[t];
+
+            // (a1 - a3) * (-i)
+            float t3r = a1i[t] - a3i[t], t3i = a3r[t] - a1r[t];
+
+            float z1r = t1r + t3r, z1i = t1i + t3i;
+            float z2r = t0r - t2r, z2i = t0i - t2i;
+            float z3r = t1r - t3r, z3i = t1i - t3i;
+
+            y0r[t] = t0r + t2r;
+            y0i[t] = t0i + t2i;
+            y1r[t] = z1r * w[0] - z1i * w[1];
+            y1i[t] = z1r * w[1] + z1i * w[0];
+            y2r[t] = z2r * w[2] - z2i * w[3];
+            y2i[t] = z2r * w[3] + z2i * w[2];
+            y3r[t] = z3r * w[4] - z3i * w[5];
+            y3i[t] = z3r * w[5] + z3i * w[4];
+        }
+    }
+}
+
+// Stage of radix 3: y[3p + k] = (sum of a_j * exp(-2 pi i j k / 3)) * w^(pk)
+static void radix3_stage(const float *xr, const float *xi, float *yr, float *yi, int m,
+  size_t run, const float *twiddles) {
+
+    const float s = static_cast<float>(std::sin(2.0 * M_PI / 3.0));
+
+    for (int p = 0; p < m; p++) {
+        const float *w = twiddles + 4 * p;
+        const float *a0r = xr + p * run, *a0i = xi + p * run;
+        const float *a1r = xr + (p + m) * run, *a1i = xi + (p + m) * run;
+        const float *a2r = xr + (p + 2 * m) * run, *a2i = xi + (p + 2 * m) * run;
+        float *y0r = yr + (3 * p) * run, *y0i = yi + (3 * p) * run;
+        float *y1r = yr + (3 * p + 1) * run, *y1i = yi + (3 * p + 1) * run;
+        float *y2r = yr + (3 * p + 2) * run, *y2i = yi + (3 * p + 2) * run;
+
+        VECTORIZE_RUN
+        for (size_t t = 0; t < run; t++) {
+            float t1r = a1r[t] + a2r[t], t1i = a1i[t] + a2i[t];
+            float br = a0r[t] - 0.5f * t1r, bi = a0i[t] - 0.5f * t1i;
+            float dr = s * (a1r[t] - a2r[t]), di = s * (a1i[t] - a2i[t]);
+
+            // b - i * d and b + i * d
+            float z1r = br + di, z1i = bi - dr;
+            float z2r = br - di, z2i = bi + dr;
+
+            y0r[t] = a0r[t] + t1r;
+            y0i[t] = a0i[t] + t1i;
+            y1r[t] = z1r * w[0] - z1i * w[1];
+            y1i[t] = z1r * w[1] + z1i * w[0];
+            y2r[t] = z2r * w[2] - z2i * w[3];
+            y2i[t] = z2r * w[3] + z2i * w[2];
+        }
+    }
+}
+
+// Stage of radix 5, with the symmetric pairs (a1, a4) and (a2, a3) combined first
+static void radix5_stage(const float *xr, const float *xi, float *yr, float *yi, int m,
+  size_t run, const float *twiddles) {
+
+    const float c1 = static_cast<float>(std::cos(2.0 * M_PI / 5.0));
+    const float c2 = static_cast<float>(std::cos(4.0 * M_PI / 5.0));
+    const float s1 = static_cast<float>(std::sin(2.0 * M_PI / 5.0));
+    const float s2 = static_cast<float>(std::sin(4.0 * M_PI / 5.0));
+
+    for (int p = 0; p < m; p++) {
+        const float *w = twiddles + 8 * p;
+        const float *a0r = xr + p * run, *a0i = xi + p * run;
+        const float *a1r = xr + (p + m) * run, *a1i = xi + (p + m) * run;
+        const float *a2r = xr + (p + 2 * m) * run, *a2i = xi + (p + 2 * m) * run;
+        const float *a3r = xr + (p + 3 * m) * run, *a3i = xi + (p + 3 * m) * run;
+        const float *a4r = xr + (p + 4 * m) * run, *a4i = xi + (p + 4 * m) * run;
+        float *y0r = yr + (5 * p) * run, *y0i = yi + (5 * p) * run;
+        float *y1r = yr + (5 * p + 1) * run, *y1i = yi + (5 * p + 1) * run;
+        float *y2r = yr + (5 * p + 2) * run, *y2i = yi + (5 * p + 2) * run;
+        float *y3r = yr + (5 * p + 3) * run, *y3i = yi + (5 * p + 3) * run;
+        float *y4r = yr + (5 * p + 4) * run, *y4i = yi + (5 * p + 4) * run;
+
+        VECTORIZE_RUN
+        for (size_t t = 0; t < run; t++) {
+            float t1r = a1r[t] + a4r[t], t1i = a1i[t] + a4i[t];
+            float t2r = a2r[t] + a3r[t], t2i = a2i[t] + a3i[t];
+            float t3r = a1r[t] - a4r[t], t3i = a1i[t] - a4i[t];
+            float t4r = a2r[t] - a3r[t], t4i = a2i[t] - a3i[t];
+
+            float b1r = a0r[t] + c1 * t1r + c2 * t2r, b1i = a0i[t] + c1 * t1i + c2 * t2i;
+            float b2r = a0r[t] + c2 * t1r + c1 * t2r, b2i = a0i[t] + c2 * t1i + c1 * t2i;
+            float d1r = s1 * t3r + s2 * t4r, d1i = s1 * t3i + s2 * t4i;
+            float d2r = s2 * t3r - s1 * t4r, d2i = s2 * t3i - s1 * t4i;
+
+            // X1 = b1 - i * d1, X2 = b2 - i * d2, X3 = b2 + i * d2 and X4 = b1 + i * d1
+            float z1r = b1r + d1i, z1i = b1i - d1r;
+            float z2r = b2r + d2i, z2i = b2i - d2r;
+            float z3r = b2r - d2i, z3i = b2i + d2r;
+            float z4r = b1r - d1i, z4i = b1i + d1r;
+
+            y0r[t] = a0r[t] + t1r + t2r;
+            y0i[t] = a0i[t] + t1i + t2i;
+            y1r[t] = z1r * w[0] - z1i * w[1];
+            y1i[t] = z1r * w[1] + z1i * w[0];
+            y2r[t] = z2r * w[2] - z2i * w[3];
+            y2i[t] = z2r * w[3] + z2i * w[2];
+            y3r[t] = z3r * w[4] - z3i * w[5];
+            y3i[t] = z3r * w[5] + z3i * w[4];
+            y4r[t] = z4r * w[6] - z4i * w[7];
+            y4i[t] = z4r * w[7] + z4i * w[6];
+        }
+    }
+}
+
+// Stage of an odd radix r, as a direct transform of length r of each group
+static void radix_stage(const float *xr, const float *xi, float *yr, float *yi, int m, int r,
+  size_t run, const float *twiddles, const float *roots) {
+
+    for (int p = 0; p < m; p++) {
+        const float *w = twiddles + 2 * (r - 1) * p;
+
+        for (int k = 0; k < r; k++) {
+            float *ykr = yr + (r * p + k) * run, *yki = yi + (r * p + k) * run;
+            const float *a0r = xr + p * run, *a0i = xi + p * run;
+
+            VECTORIZE_RUN
+        for (size_t t = 0; t < run; t++) {
+                ykr[t] = a0r[t];
+                yki[t] = a0i[t];
+            }
+
+            for (int j = 1; j < r; j++) {
+                const float rr = roots[2 * ((j * k) % r)];
+                const float ri = roots[2 * ((j * k) % r) + 1];
+                const float *ajr = xr + (p + j * m) * run, *aji = xi + (p + j * m) * run;
+
+                VECTORIZE_RUN
+        for (size_t t = 0; t < run; t++) {
+                    ykr[t] += ajr[t] * rr - aji[t] * ri;
+                    yki[t] += ajr[t] * ri + aji[t] * rr;
+                }
+            }
+
+            if (k > 0) {
+                const float wr = w[2 * (k - 1)];
+                const float wi = w[2 * (k - 1) + 1];
+
+                VECTORIZE_RUN
+        for (size_t t = 0; t < run; t++) {
+                    float vr = ykr[t];
+                    ykr[t] = vr * wr - yki[t] * wi;
+                    yki[t] = vr * wi + yki[t] * wr;
+                }
+            }
+        }
+    }
+}
+
+void create_fourier_plan(int length, FourierPlan &plan) {
+    int n = length;
+
+    plan.length = length;
+    plan.radices.clear();
+    plan.twiddles.clear();
+    plan.roots.clear();
+
+    while (n % 4 == 0 && n > 1) {
+        plan.radices.push_back(4);
+        n /= 4;
+    }
+
+    while (n % 2 == 0 && n > 1) {
+        plan.radices.push_back(2);
+        n /= 2;
+    }
+
+    for (int factor = 3; n > 1; factor += 2) {
+        while (n % factor == 0) {
+            plan.radices.push_back(factor);
+            n /= factor;
+        }
+
+        if (factor * factor > n && n > 1) {
+            plan.radices.push_back(n);
+            n = 1;
+        }
+    }
+
+    // Twiddle factors exp(-2 pi i p k / n) of each stage, for p < n / r and 0 < k < r
+    n = length;
+
+    for (size_t i = 0; i < plan.radices.size(); i++) {
+        int r = plan.radices[i];
+        int m = n / r;
+
+        for (int p = 0; p < m; p++) {
+            for (int k = 1; k < r; k++) {
+                double angle = -2.0 * M_PI * p * k / n;
+                plan.twiddles.push_back(static_cast<float>(std::cos(angle)));
+                plan.twiddles.push_back(static_cast<float>(std::sin(angle)));
+            }
+        }
+
+        if (r > 5) {
+            for (int j = 0; j < r; j++) {
+                double angle = -2.0 * M_PI * j / r;
+                plan.roots.push_back(static_cast<float>(std::cos(angle)));
+                plan.roots.push_back(static_cast<float>(std::sin(angle)));
+            }
+        }
+
+        n = m;
+    }
+}
+
+void transform_lanes(const FourierPlan &plan, float *real, float *imaginary, float *work_real,
+  float *work_imaginary, int lanes) {
+
+    float *xr = real, *xi = imaginary, *yr = work_real, *yi = work_imaginary;
+    const float *twiddles = plan.twiddles.empty() ? NULL : &plan.twiddles[0];
+    const float *roots = plan.roots.empty() ? NULL : &plan.roots[0];
+    int n = plan.length;
+    size_t run = lanes;
+
+    // Each stage reads groups of n / r values spaced by n / r runs, and writes the r outputs of
+    // each group side by side, so the output is in natural order without a bit reversal
+    for (size_t i = 0; i < plan.radices.size(); i++) {
+        int r = plan.radices[i];
+        int m = n / r;
+
+        if (r == 4) {
+            radix4_stage(xr, xi, yr, yi, m, run, twiddles);
+        } else if (r == 2) {
+            radix2_stage(xr, xi, yr, yi, m, run, twiddles);
+        } else if (r == 3) {
+            radix3_stage(xr, xi, yr, yi, m, run, twiddles);
+        } else if (r == 5) {
+            radix5_stage(xr, xi, yr, yi, m, run, twiddles);
+        } else {
+            radix_stage(xr, xi, yr, yi, m, r, run, twiddles, roots);
+            roots += 2 * r;
+        }
+
+        twiddles += 2 * (r - 1) * m;
+        std::swap(xr, yr);
+        std::swap(xi, yi);
+        n = m;
+        run *= r;
+    }
+
+    if (xr != real) {
+        std::copy(xr, xr + static_cast<size_t>(plan.length) * lanes, real);
+        std::copy(xi, xi + static_cast<size_t>(plan.length) * lanes, imaginary);
+    }
+}
+
+BatchSpectrum::BatchSpectrum() {
+    this->batch_size = 8;
+    this->frame_number = 0;
+    this->rows = 0;
+    this->cols = 0;
+    this->row_plan.length = 0;
+    this->column_plan.length = 0;
+}
+
+void BatchSpectrum::set_batch_size(int batch_size) {
+    this->batch_size = std::max(1, std::min(batch_size, MAX_SPECTRUM_BATCH));
+    this->frame_number = 0;
+}
+
+int BatchSpectrum::get_batch_size() const {
+    return this->batch_size;
+}
+
+int BatchSpectrum::get_frame_number() const {
+    return this->frame_number;
+}
+
+bool BatchSpectrum::is_full() const {
+    return this->frame_number >= this->batch_size;
+}
+
+bool BatchSpectrum::is_compatible(const Mat &frame) const {
+    return this->frame_number == 0 || (frame.rows == this->rows && frame.cols == this->cols);
+}
+
+void BatchSpectrum::clear() {
+    this->frame_number = 0;
+}
+
+void BatchSpectrum::add(const Mat &frame) {
+    const int lanes = this->batch_size;
+
+    if (this->frame_number == 0) {
+        this->rows = frame.rows;
+        this->cols = frame.cols;
+
+        size_t size = static_cast<size_t>(this->rows) * this->cols * lanes;
+        this->real.resize(size);
+        this->imaginary.resize(size);
+
+        if (this->row_plan.length != this->cols) {
+            create_fourier_plan(this->cols, this->row_plan);
+        }
+
+        if (this->column_plan.length != this->rows) {
+            create_fourier_plan(this->rows, this->column_plan);
+        }
+    }
+
+    const int b = this->frame_number;
+
+    for (int y = 0; y < this->rows; y++) {
+        const uchar *pixels = frame.ptr<uchar>(y);
+        float *re = &this->real[static_cast<size_t>(y) * this->cols * lanes];
+        float *im = &this->imaginary[static_cast<size_t>(y) * this->cols * lanes];
+
+        for (int x = 0; x < this->cols; x++) {
+            re[x * lanes + b] = pixels[x];
+            im[x * lanes + b] = 0.0f;
+        }
+    }
+
+    this->frame_number++;
+}
+
+void BatchSpectrum::transform(ThreadPool *thread_pool) {
+
+    // The lanes after the frames of a partial batch are transformed too (the lanes are
+    // independent) and ignored
+    if (this->frame_number == 0) {
+        return;
+    }
+
+    if (thread_pool == NULL || thread_pool->get_thread_number() == 1) {
+        transform_rows(0, this->rows);
+        transform_columns(0, this->cols);
+        return;
+    }
+
+    int band_number = 2 * thread_pool->get_thread_number();
+    int row_band_number = std::min(band_number, this->rows);
+    int column_band_number = std::min(band_number, this->cols);
+
+    thread_pool->parallel_for(row_band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(this->rows, row_band_number, band, begin, end);
+        transform_rows(begin, end);
+    });
+
+    thread_pool->parallel_for(column_band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(this->cols, column_band_number, band, begin, end);
+        transform_columns(begin, end);
+    });
+}
+
+void BatchSpectrum::transform_rows(int begin, int end) {
+    const int lanes = this->batch_size;
+    const size_t row_size = static_cast<size_t>(this->cols) * lanes;
+    vector<float> work(2 * row_size);
+
+    // The values of a row are already contiguous, with the frames side by side
+    for (int y = begin; y < end; y++) {
+        transform_lanes(this->row_plan, &this->real[y * row_size], &this->imaginary[y * row_size],
+          &work[0], &work[row_size], lanes);
+    }
+}
+
+void BatchSpectrum::transform_columns(int begin, int end) {
+    const int lanes = this->batch_size;
+    const size_t row_size = static_cast<size_t>(this->cols) * lanes;
+    const size_t column_size = static_cast<size_t>(this->rows) * lanes;
+    vector<float> column(2 * column_size);
+    vector<float> work(2 * column_size);
+    float *column_real = &column[0];
+    float *column_imaginary = &column[column_size];
+
+    // Each column is gathered into a contiguous buffer, one run of lanes per row
+    for (int x = begin; x < end; x++) {
+        for (int y = 0; y < this->rows; y++) {
+            const float *re = &this->real[y * row_size + x * lanes];
+            const float *im = &this->imaginary[y * row_size + x * lanes];
+
+            std::copy(re, re + lanes, column_real + y * lanes);
+            std::copy(im, im + lanes, column_imaginary + y * lanes);
+        }
+
+        transform_lanes(this->column_plan, column_real, column_imaginary, &work[0],
+          &work[column_size], lanes);
+
+        for (int y = 0; y < this->rows; y++) {
+            std::copy(column_real + y * lanes, column_real + (y + 1) * lanes,
+              &this->real[y * row_size + x * lanes]);
+            std::copy(column_imaginary + y * lanes, column_imaginary + (y + 1) * lanes,
+              &this->imaginary[y * row_size + x * lanes]);
+        }
+    }
+}
+
+void BatchSpectrum::get_log_magnitude(int frame, Mat &output) const {
+    const int lanes = this->batch_size;
+
+    output.create(this->rows, this->cols, CV_32F);
+
+    for (int y = 0; y < this->rows; y++) {
+        const float *re = &this->real[static_cast<size_t>(y) * this->cols * lanes + frame];
+        const float *im = &this->imaginary[static_cast<size_t>(y) * this->cols * lanes + frame];
+        float *magnitude = output.ptr<float>(y);
+
+        for (int x = 0; x < this->cols; x++) {
+            float r = re[x * lanes];
+            float i = im[x * lanes];
+            magnitude[x] = std::log(1.0f + std::sqrt(r * r + i * i));
+        }
+    }
+}
+
+void BatchSpectrum::get_fast_log_magnitude(int frame, Mat &output, float &min_value,
+  float &max_value) const {
+
+    const int lanes = this->batch_size;
+    const int even_rows = this->rows & -2;
+    const int even_cols = this->cols & -2;
+    vector<float> values(2 * even_cols);
+
+    output.create(even_rows, even_cols, CV_32F);
+    min_value = FLT_MAX;
+    max_value = -FLT_MAX;
+
+    for (int y = 0; y < even_rows; y++) {
+        const float *re = &this->real[static_cast<size_t>(y) * this->cols * lanes + frame];
+        const float *im = &this->imaginary[static_cast<size_t>(y) * this->cols * lanes + frame];
+
+        for (int x = 0; x < even_cols; x++) {
+            values[2 * x] = re[x * lanes];
+            values[2 * x + 1] = im[x * lanes];
+        }
+
+        fast_log_magnitude(&values[0], output.ptr<float>(y), even_cols, min_value, max_value);
+    }
+}
@@ -0,0 +1,145 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef BATCHSPECTRUM_H_
+#define BATCHSPECTRUM_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+
+#include "threadpool.h"
+
+using namespace std;
+using namespace cv;
+
+// Largest number of frames transformed together
+#define MAX_SPECTRUM_BATCH 64
+
+// Plan of a one-dimensional transform of a given length: its radices and twiddle factors
+struct FourierPlan {
+
+    // Length of the transform
+    int length;
+
+    // Radix of each stage (4, 2 and then the odd prime factors of the length)
+    vector<int> radices;
+
+    // Twiddle factors of each stage, interleaved complex values
+    vector<float> twiddles;
+
+    // Roots of unity of each radix above 5, interleaved complex values
+    vector<float> roots;
+
+};
+
+// Class liable for the two-dimensional Fourier transforms of a batch of frames of the same size.
+// The frames are interleaved, so that each complex value is stored for all frames of the batch
+// side by side, and the row and column transforms (mixed radix, self-sorting Stockham) process
+// every frame of the batch in the same SIMD operations. Each stride of the transforms is a
+// contiguous run of values, including the column pass, which is gathered by rows.
+class BatchSpectrum {
+
+private:
+
+    // Number of frames of a full batch
+    int batch_size;
+
+    // Number of frames added to the current batch
+    int frame_number;
+
+    // Size of the frames of the current batch
+    int rows;
+    int cols;
+
+    // Real and imaginary parts, frame-interleaved: value (y, x) of frame b is at
+    // (y * cols + x) * batch_size + b
+    vector<float> real;
+    vector<float> imaginary;
+
+    // Plans of the row and column transforms
+    FourierPlan row_plan;
+    FourierPlan column_plan;
+
+    // To transform the rows [begin, end)
+    void transform_rows(int begin, int end);
+
+    // To transform the columns [begin, end)
+    void transform_columns(int begin, int end);
+
+public:
+
+    // Constructor
+    BatchSpectrum();
+
+    // To set the number of frames of a full batch
+    void set_batch_size(int batch_size);
+
+    // To get the number of frames of a full batch
+    int get_batch_size() const;
+
+    // To get the number of frames added to the current batch
+    int get_frame_number() const;
+
+    // Is the batch full?
+    bool is_full() const;
+
+    // Can a frame of this size be added to the current batch?
+    bool is_compatible(const Mat &frame) const;
+
+    // To add an 8-bit frame to the batch
+    void add(const Mat &frame);
+
+    // To compute the transforms of the frames of the batch (in parallel when a pool is given)
+    void transform(ThreadPool *thread_pool);
+
+    // To get log(1 + |X|) of a transformed frame
+    void get_log_magnitude(int frame, Mat &output) const;
+
+    // To get the approximate 0.5 * log(1 + |X|^2) of the even rows and columns of a transformed
+    // frame, with its minimum and maximum values (see fastspectrum.h)
+    void get_fast_log_magnitude(int frame, Mat &output, float &min_value,
+      float &max_value) const;
+
+    // To start a new batch
+    void clear();
+
+};
+
+// To create the plan of a transform of a given length
+void create_fourier_plan(int length, FourierPlan &plan);
+
+// To compute in place the transforms of lanes interleaved sequences of plan.length complex
+// values (value k of lane b at k * lanes + b), using work buffers of the same size
+void transform_lanes(const FourierPlan &plan, float *real, float *imaginary, float *work_real,
+  float *work_imaginary, int lanes);
+
+#endif /* BATCHSPECTRUM_H_ */
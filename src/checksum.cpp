@@ -0,0 +1,221 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "checksum.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Primes of XXH64
+static const uint64_t PRIME1 = 11400714785074694791ULL;
+static const uint64_t PRIME2 = 14029467366897019727ULL;
+static const uint64_t PRIME3 = 1609587929392839161ULL;
+static const uint64_t PRIME4 = 9650029242287828579ULL;
+static const uint64_t PRIME5 = 2870177450012600261ULL;
+
+// Size of the reads of compute_file_checksum
+#define CHECKSUM_READ_SIZE (1 << 20)
+
+static inline uint64_t rotate_left(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// The input is read in little-endian order, as the x86 processors store it
+static inline uint64_t read64(const unsigned char *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t read32(const unsigned char *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t round_lane(uint64_t lane, uint64_t input) {
+    lane += input * PRIME2;
+    lane = rotate_left(lane, 31);
+    return lane * PRIME1;
+}
+
+static inline uint64_t merge_lane(uint64_t hash, uint64_t lane) {
+    hash ^= round_lane(0, lane);
+    return hash * PRIME1 + PRIME4;
+}
+
+Checksum::Checksum(uint64_t seed) {
+    reset(seed);
+}
+
+void Checksum::reset(uint64_t seed) {
+    this->seed = seed;
+    this->lanes[0] = seed + PRIME1 + PRIME2;
+    this->lanes[1] = seed + PRIME2;
+    this->lanes[2] = seed;
+    this->lanes[3] = seed - PRIME1;
+    this->pending_size = 0;
+    this->total_size = 0;
+}
+
+void Checksum::consume_block(const unsigned char *block) {
+    this->lanes[0] = round_lane(this->lanes[0], read64(block));
+    this->lanes[1] = round_lane(this->lanes[1], read64(block + 8));
+    this->lanes[2] = round_lane(this->lanes[2], read64(block + 16));
+    this->lanes[3] = round_lane(this->lanes[3], read64(block + 24));
+}
+
+void Checksum::update(const void *data, size_t size) {
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    const unsigned char *end = p + size;
+
+    this->total_size += size;
+
+    if (this->pending_size > 0) {
+        size_t missing = std::min(sizeof(this->pending) - this->pending_size, size);
+
+        memcpy(this->pending + this->pending_size, p, missing);
+        this->pending_size += missing;
+        p += missing;
+
+        if (this->pending_size < sizeof(this->pending)) {
+            return;
+        }
+
+        consume_block(this->pending);
+        this->pending_size = 0;
+    }
+
+    // Lanes kept in registers for the bulk of the input
+    uint64_t v1 = this->lanes[0], v2 = this->lanes[1], v3 = this->lanes[2], v4 = this->lanes[3];
+
+    while (end - p >= 32) {
+        v1 = round_lane(v1, read64(p));
+        v2 = round_lane(v2, read64(p + 8));
+        v3 = round_lane(v3, read64(p + 16));
+        v4 = round_lane(v4, read64(p + 24));
+        p += 32;
+    }
+
+    this->lanes[0] = v1;
+    this->lanes[1] = v2;
+    this->lanes[2] = v3;
+    this->lanes[3] = v4;
+
+    if (p < end) {
+        memcpy(this->pending, p, end - p);
+        this->pending_size = end - p;
+    }
+}
+
+uint64_t Checksum::get_digest() const {
+    uint64_t hash = 0;
+
+    if (this->total_size >= 32) {
+        hash = rotate_left(this->lanes[0], 1) + rotate_left(this->lanes[1], 7) +
+          rotate_left(this->lanes[2], 12) + rotate_left(this->lanes[3], 18);
+        hash = merge_lane(hash, this->lanes[0]);
+        hash = merge_lane(hash, this->lanes[1]);
+        hash = merge_lane(hash, this->lanes[2]);
+        hash = merge_lane(hash, this->lanes[3]);
+    } else {
+        hash = this->seed + PRIME5;
+    }
+
+    hash += this->total_size;
+
+    // Bytes left out of the blocks
+    const unsigned char *p = this->pending;
+    const unsigned char *end = p + this->pending_size;
+
+    while (end - p >= 8) {
+        hash ^= round_lane(0, read64(p));
+        hash = rotate_left(hash, 27) * PRIME1 + PRIME4;
+        p += 8;
+    }
+
+    if (end - p >= 4) {
+        hash ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        hash = rotate_left(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+
+    while (p < end) {
+        hash ^= (*p) * PRIME5;
+        hash = rotate_left(hash, 11) * PRIME1;
+        p++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+uint64_t compute_checksum(const void *data, size_t size, uint64_t seed) {
+    Checksum checksum(seed);
+    checksum.update(data, size);
+    return checksum.get_digest();
+}
+
+bool compute_file_checksum(const string &filename, uint64_t &checksum, long long &size) {
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+
+    if (descriptor < 0) {
+        return false;
+    }
+
+    vector<unsigned char> buffer(CHECKSUM_READ_SIZE);
+    Checksum stream;
+    ssize_t length = 0;
+
+    size = 0;
+
+    while ((length = ::read(descriptor, &buffer[0], buffer.size())) > 0) {
+        stream.update(&buffer[0], static_cast<size_t>(length));
+        size += length;
+    }
+
+    ::close(descriptor);
+
+    if (length < 0) {
+        return false;
+    }
+
+    checksum = stream.get_digest();
+    return true;
+}
@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef CHECKSUM_H_
+#define CHECKSUM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Class liable for a 64-bit checksum of a stream of bytes, with the algorithm of XXH64. The
+// input is consumed in blocks of 32 bytes by four independent lanes, so the checksum runs near
+// the speed of memory. It detects truncated and corrupted files, but it is not a cryptographic
+// hash.
+class Checksum {
+
+private:
+
+    // Lanes of the blocks of 32 bytes
+    uint64_t lanes[4];
+
+    // Bytes not yet consumed, less than one block
+    unsigned char pending[32];
+    size_t pending_size;
+
+    // Number of bytes given to the checksum
+    uint64_t total_size;
+
+    // Seed of the checksum
+    uint64_t seed;
+
+    // To consume one block of 32 bytes
+    void consume_block(const unsigned char *block);
+
+public:
+
+    // Constructor
+    Checksum(uint64_t seed = 0);
+
+    // To restart the checksum
+    void reset(uint64_t seed = 0);
+
+    // To append bytes to the stream
+    void update(const void *data, size_t size);
+
+    // To get the checksum of the bytes given so far
+    uint64_t get_digest() const;
+
+};
+
+// To compute the checksum of a buffer
+uint64_t compute_checksum(const void *data, size_t size, uint64_t seed = 0);
+
+// To compute the checksum and the size of a file, returns false if it can not be read
+bool compute_file_checksum(const string &filename, uint64_t &checksum, long long &size);
+
+#endif /* CHECKSUM_H_ */
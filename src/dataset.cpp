@@ -0,0 +1,241 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "dataset.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// Magic numbers of the header and of the footer, and version of the layout
+#define DATASET_MAGIC "VRDS"
+#define DATASET_INDEX_MAGIC "VRDX"
+#define DATASET_VERSION 1
+
+// Size of the reads of add_file
+#define DATASET_COPY_SIZE (1 << 20)
+
+// The integers are stored in little endian, as the x86 processors store them
+template<typename T>
+static void write_integer(ostream &stream, T value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+static bool read_integer(istream &stream, T &value) {
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static void write_name(ostream &stream, const string &name) {
+    write_integer<uint32_t>(stream, static_cast<uint32_t>(name.size()));
+    stream.write(name.data(), name.size());
+}
+
+static bool read_name(istream &stream, string &name) {
+    uint32_t length = 0;
+
+    if (!read_integer(stream, length) || length > (1U << 16)) {
+        return false;
+    }
+
+    name.resize(length);
+    return length == 0 || static_cast<bool>(stream.read(&name[0], length));
+}
+
+bool DatasetWriter::open(const string &filename) {
+    this->filename = filename;
+    this->entries.clear();
+    this->file.open((filename + ".tmp").c_str(), ios::binary | ios::trunc);
+
+    if (!this->file.is_open()) {
+        cout << "Error:DatasetWriter::open():Could not create " << filename << ".tmp" << endl;
+        return false;
+    }
+
+    this->file.write(DATASET_MAGIC, 4);
+    write_integer<uint32_t>(this->file, DATASET_VERSION);
+
+    return static_cast<bool>(this->file);
+}
+
+bool DatasetWriter::add(const string &name, const char *data, uint64_t size) {
+    DatasetEntry entry;
+
+    write_name(this->file, name);
+    write_integer<uint64_t>(this->file, size);
+
+    entry.name = name;
+    entry.offset = static_cast<uint64_t>(this->file.tellp());
+    entry.size = size;
+
+    this->file.write(data, size);
+    this->entries.push_back(entry);
+
+    return static_cast<bool>(this->file);
+}
+
+bool DatasetWriter::add_file(const string &name, const string &path) {
+    ifstream input(path.c_str(), ios::binary | ios::ate);
+
+    if (!input.is_open()) {
+        cout << "Error:DatasetWriter::add_file():Could not open " << path << endl;
+        return false;
+    }
+
+    DatasetEntry entry;
+    uint64_t size = static_cast<uint64_t>(input.tellg());
+    vector<char> buffer(DATASET_COPY_SIZE);
+
+    input.seekg(0);
+
+    write_name(this->file, name);
+    write_integer<uint64_t>(this->file, size);
+
+    entry.name = name;
+    entry.offset = static_cast<uint64_t>(this->file.tellp());
+    entry.size = size;
+
+    for (uint64_t copied = 0; copied < size; ) {
+        streamsize length = static_cast<streamsize>(std::min<uint64_t>(buffer.size(),
+          size - copied));
+
+        if (!input.read(&buffer[0], length)) {
+            cout << "Error:DatasetWriter::add_file():Could not read " << path << endl;
+            return false;
+        }
+
+        this->file.write(&buffer[0], length);
+        copied += length;
+    }
+
+    this->entries.push_back(entry);
+
+    return static_cast<bool>(this->file);
+}
+
+bool DatasetWriter::close() {
+    uint64_t index_offset = static_cast<uint64_t>(this->file.tellp());
+
+    write_integer<uint64_t>(this->file, this->entries.size());
+
+    for (size_t i = 0; i < this->entries.size(); i++) {
+        write_name(this->file, this->entries[i].name);
+        write_integer<uint64_t>(this->file, this->entries[i].offset);
+        write_integer<uint64_t>(this->file, this->entries[i].size);
+    }
+
+    write_integer<uint64_t>(this->file, index_offset);
+    this->file.write(DATASET_INDEX_MAGIC, 4);
+    this->file.close();
+
+    if (this->file.fail()) {
+        cout << "Error:DatasetWriter::close():Could not write " << this->filename << ".tmp";
+        cout << endl;
+        return false;
+    }
+
+    if (rename((this->filename + ".tmp").c_str(), this->filename.c_str()) != 0) {
+        cout << "Error:DatasetWriter::close():Could not rename to " << this->filename << endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool DatasetReader::open(const string &filename) {
+    char magic[4];
+    uint32_t version = 0;
+    uint64_t index_offset = 0, entry_number = 0;
+
+    this->filename = filename;
+    this->entries.clear();
+    this->file.open(filename.c_str(), ios::binary);
+
+    if (!this->file.is_open()) {
+        cout << "Error:DatasetReader::open():Could not open " << filename << endl;
+        return false;
+    }
+
+    if (!this->file.read(magic, 4) || memcmp(magic, DATASET_MAGIC, 4) != 0 ||
+          !read_integer(this->file, version) || version != DATASET_VERSION) {
+        cout << "Error:DatasetReader::open():Invalid dataset " << filename << endl;
+        return false;
+    }
+
+    this->file.seekg(-12, ios::end);
+
+    if (!read_integer(this->file, index_offset) || !this->file.read(magic, 4) ||
+          memcmp(magic, DATASET_INDEX_MAGIC, 4) != 0) {
+        cout << "Error:DatasetReader::open():Dataset without index " << filename << endl;
+        return false;
+    }
+
+    this->file.seekg(index_offset);
+
+    if (!read_integer(this->file, entry_number)) {
+        cout << "Error:DatasetReader::open():Invalid index in " << filename << endl;
+        return false;
+    }
+
+    for (uint64_t i = 0; i < entry_number; i++) {
+        DatasetEntry entry;
+
+        if (!read_name(this->file, entry.name) || !read_integer(this->file, entry.offset) ||
+              !read_integer(this->file, entry.size) || entry.offset + entry.size > index_offset) {
+            cout << "Error:DatasetReader::open():Invalid index in " << filename << endl;
+            this->entries.clear();
+            return false;
+        }
+
+        this->entries.push_back(entry);
+    }
+
+    return true;
+}
+
+const vector<DatasetEntry>& DatasetReader::get_entries() const {
+    return this->entries;
+}
+
+bool DatasetReader::read(const DatasetEntry &entry, vector<char> &data) {
+    data.resize(entry.size);
+
+    this->file.clear();
+    this->file.seekg(entry.offset);
+
+    if (entry.size > 0 && !this->file.read(&data[0], entry.size)) {
+        cout << "Error:DatasetReader::read():Could not read " << entry.name << " from ";
+        cout << this->filename << endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,117 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef DATASET_H_
+#define DATASET_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Entry of the index of a dataset
+struct DatasetEntry {
+
+    // Name of the visual rhythm (the output file name given in the manifest)
+    string name;
+
+    // Position of the data in the file, in bytes
+    uint64_t offset;
+
+    // Size of the data, in bytes
+    uint64_t size;
+
+};
+
+// Class liable for writing a dataset container, a single file with the encoded visual rhythms
+// of a batch (the bytes of their output files) and an index at its end. The layout, in little
+// endian, is the header "VRDS" and version, the records (name length, name, data size, data),
+// the index (number of entries, then name length, name, offset and size of each entry) and the
+// footer (offset of the index and "VRDX"). The file is written under a temporary name and
+// renamed when it is closed, so a dataset is either complete or missing.
+class DatasetWriter {
+
+private:
+
+    // Output file name
+    string filename;
+
+    // Temporary file
+    ofstream file;
+
+    // Index of the records written
+    vector<DatasetEntry> entries;
+
+public:
+
+    // To create the dataset
+    bool open(const string &filename);
+
+    // To append a visual rhythm
+    bool add(const string &name, const char *data, uint64_t size);
+
+    // To append the content of a file
+    bool add_file(const string &name, const string &path);
+
+    // To write the index and move the dataset to its name
+    bool close();
+
+};
+
+// Class liable for reading the index and the records of a dataset container
+class DatasetReader {
+
+private:
+
+    // Input file name
+    string filename;
+
+    // Input file
+    ifstream file;
+
+    // Index of the dataset
+    vector<DatasetEntry> entries;
+
+public:
+
+    // To open a dataset and read its index
+    bool open(const string &filename);
+
+    // To get the index of the dataset
+    const vector<DatasetEntry>& get_entries() const;
+
+    // To read the data of an entry
+    bool read(const DatasetEntry &entry, vector<char> &data);
+
+};
+
+#endif /* DATASET_H_ */
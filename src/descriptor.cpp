@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "descriptor.h"
+
+#include <algorithm>
+
+void compute_glcm_descriptor(const Mat &image, vector<float> &descriptor, int bins,
+  int distance) {
+
+    // Offsets (dy, dx) of the directions 0, 45, 90 and 135 degrees
+    const int offsets[4][2] = { { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 } };
+    const int size = bins * bins;
+
+    descriptor.assign(4 * size, 0.0f);
+
+    vector<uchar> quantized(image.rows * image.cols);
+
+    for (int y = 0; y < image.rows; y++) {
+        const uchar *row = image.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; x++) {
+            quantized[y * image.cols + x] = static_cast<uchar>((row[x] * bins) >> 8);
+        }
+    }
+
+    for (int d = 0; d < 4; d++) {
+        int dy = offsets[d][0] * distance;
+        int dx = offsets[d][1] * distance;
+        float *matrix = &descriptor[d * size];
+        double pairs = 0.0;
+
+        for (int y = std::max(0, -dy); y < std::min(image.rows, image.rows - dy); y++) {
+            const uchar *row = &quantized[y * image.cols];
+            const uchar *neighbour = &quantized[(y + dy) * image.cols];
+
+            for (int x = std::max(0, -dx); x < std::min(image.cols, image.cols - dx); x++) {
+                matrix[row[x] * bins + neighbour[x + dx]] += 1.0f;
+                pairs += 1.0;
+            }
+        }
+
+        if (pairs > 0.0) {
+            for (int i = 0; i < size; i++) {
+                matrix[i] = static_cast<float>(matrix[i] / pairs);
+            }
+        }
+    }
+}
@@ -0,0 +1,212 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "extraction.h"
+
+bool compute_visual_rhythm(const Parameters &parameters, Video &processor,
+  VisualRhythm &visual_rhythm) {
+
+    if (!extract_visual_rhythm(parameters, processor, visual_rhythm)) {
+        return false;
+    }
+
+    if (parameters.verbose) {
+        cout << "Saving the generated visual rhythm ... ";
+    }
+
+    if (!visual_rhythm.save_visual_rhythm()) {
+        return false;
+    }
+
+    if (parameters.verbose) {
+        cout << "Ok!" << endl;
+        cout << "Done!\n" << endl;
+    }
+
+    return true;
+}
+
+void configure_visual_rhythm(const Parameters &parameters, VisualRhythm &visual_rhythm) {
+    visual_rhythm.reset();
+    visual_rhythm.set_visual_rhythm_type(parameters.visual_rhythm_type);
+    visual_rhythm.set_color_space(parameters.color_space);
+    visual_rhythm.set_filter(parameters.filter);
+    visual_rhythm.set_kernel_size(parameters.kernel_size);
+    visual_rhythm.set_variance(parameters.variance);
+    visual_rhythm.set_fast_spectrum(parameters.fast_spectrum == 1);
+    visual_rhythm.set_spectrum_batch(parameters.spectrum_batch);
+    visual_rhythm.set_row_fusion(parameters.row_fusion == 1);
+    visual_rhythm.set_skip_duplicates(parameters.skip_duplicates == 1);
+    visual_rhythm.set_score_interval(parameters.score_interval);
+    visual_rhythm.set_score_thresholds(parameters.reject_threshold, parameters.accept_threshold);
+    visual_rhythm.set_width(parameters.roi_width);
+    visual_rhythm.set_windows(parameters.window_length, parameters.window_stride,
+      parameters.max_windows);
+    visual_rhythm.set_output_filename(parameters.output_image.c_str());
+}
+
+void report_decision(const VisualRhythm &visual_rhythm) {
+
+    if (visual_rhythm.get_decision() == 0) {
+        cout << "No early decision (score " << visual_rhythm.get_score() << ") after ";
+        cout << visual_rhythm.get_frame_number() << " frames" << endl;
+        return;
+    }
+
+    cout << "Decision: " << ((visual_rhythm.get_decision() > 0) ? "genuine" : "attack");
+    cout << " (score " << visual_rhythm.get_score() << ") after ";
+    cout << visual_rhythm.get_decision_frame() << " frames" << endl;
+}
+
+void report_triage(Video &processor) {
+
+    long total_frame_number = processor.get_total_frame_count();
+    long frame_number = processor.get_triage_frame_number();
+
+    cout << "Triage decoded " << frame_number << " of " << total_frame_number << " frames";
+
+    if (total_frame_number > 0) {
+        cout << " (" << 100.0 * (total_frame_number - frame_number) / total_frame_number;
+        cout << "% avoided)";
+    }
+
+    cout << ((processor.is_keyframe_index()) ? " at the keyframes of the index" :
+      " at evenly spaced frames, without a keyframe index") << endl;
+}
+
+bool extract_visual_rhythm(const Parameters &parameters, Video &processor,
+  VisualRhythm &visual_rhythm) {
+
+    if (!processor.set_input_video(parameters.input_video.c_str())) {
+        if (parameters.verbose) {
+            cout << "Error:extract_visual_rhythm():Could not open " << parameters.input_video;
+            cout << endl;
+        }
+        return false;
+    }
+
+    return extract_opened_visual_rhythm(parameters, processor, visual_rhythm);
+}
+
+bool extract_opened_visual_rhythm(const Parameters &parameters, Video &processor,
+  VisualRhythm &visual_rhythm) {
+
+    int height = 0;
+    string description = "";
+
+    processor.set_frame_processor(&visual_rhythm);
+    processor.set_pipelined(parameters.pipeline == 1);
+
+    configure_visual_rhythm(parameters, visual_rhythm);
+
+    long frame_number = parameters.frame_number;
+
+    // The triage stops when its keyframes are read
+    if (parameters.triage == 1) {
+        frame_number = processor.set_triage(parameters.frame_number);
+        processor.set_frame_to_stop(-1);
+
+        if (frame_number == 0) {
+            if (parameters.verbose) {
+                cout << "Error:extract_visual_rhythm():No frames to triage in ";
+                cout << parameters.input_video << endl;
+            }
+            return false;
+        }
+    } else if (parameters.window_length > 0) {
+        processor.set_frame_to_stop(visual_rhythm.get_window_frame_number());
+    } else {
+        processor.set_frame_to_stop(parameters.frame_number);
+    }
+
+    if (!visual_rhythm.set_score_model(parameters.score_model)) {
+        return false;
+    }
+
+    if (parameters.visual_rhythm_type == 0) {
+        description = "vertical";
+        height = processor.get_frame_height();
+    } else if (parameters.visual_rhythm_type == 1) {
+        description = "horizontal";
+        height = processor.get_frame_width();
+    } else if (parameters.visual_rhythm_type == 2) {
+        description = "zig-zag";
+        height = visual_rhythm.compute_dimensions_visual_rhythm(processor.get_frame_height(),
+          processor.get_frame_width());
+    } else {
+        if (parameters.verbose) {
+            cout << "Invalid type for visual rhythm!" << endl;
+        }
+        return false;
+    }
+
+    if (parameters.verbose) {
+        cout << "Extracting " << description << " visual rhythm ... ";
+    }
+
+    visual_rhythm.set_height(height);
+
+    // The visual rhythms of the windows are allocated when the windows start
+    if (parameters.streaming_output == 1) {
+        if (!visual_rhythm.open_streaming_output()) {
+            return false;
+        }
+    } else if (parameters.row_statistics == 1) {
+        visual_rhythm.open_row_statistics();
+    } else if (parameters.window_length == 0) {
+        visual_rhythm.create_visual_rhythm(height, parameters.roi_width * frame_number);
+    }
+
+    processor.run();
+
+    if (parameters.verbose) {
+        cout << "Ok!" << endl;
+    }
+
+    if (parameters.verbose && !parameters.score_model.empty()) {
+        report_decision(visual_rhythm);
+    }
+
+    if (parameters.verbose && parameters.window_length > 0) {
+        cout << "Saved " << visual_rhythm.get_saved_window_number() << " windows" << endl;
+    }
+
+    if (parameters.verbose && parameters.skip_duplicates == 1) {
+        cout << "Reused the strip of the previous frame for ";
+        cout << visual_rhythm.get_duplicate_frame_number() << " duplicate frames of ";
+        cout << visual_rhythm.get_frame_number() << endl;
+    }
+
+    if (parameters.verbose && parameters.triage == 1) {
+        report_triage(processor);
+    }
+
+    return true;
+}
@@ -0,0 +1,61 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef EXTRACTION_H_
+#define EXTRACTION_H_
+
+#include "parameters.h"
+#include "video.h"
+#include "visualrhythm.h"
+
+// To compute the visual rhythm of the input video described by the parameters and save it. The
+// video and visual rhythm objects may be reused between calls to keep their buffers allocated.
+// Returns false if the visual rhythm could not be computed or could not be written.
+bool compute_visual_rhythm(const Parameters &parameters, Video &processor,
+  VisualRhythm &visual_rhythm);
+
+// To compute the visual rhythm of the input video described by the parameters without saving it
+bool extract_visual_rhythm(const Parameters &parameters, Video &processor,
+  VisualRhythm &visual_rhythm);
+
+// To compute the visual rhythm of the input already opened by the video, without saving it
+bool extract_opened_visual_rhythm(const Parameters &parameters, Video &processor,
+  VisualRhythm &visual_rhythm);
+
+// To set the parameters of the visual rhythm
+void configure_visual_rhythm(const Parameters &parameters, VisualRhythm &visual_rhythm);
+
+// To print the early decision taken on the partial visual rhythm and the frames it used
+void report_decision(const VisualRhythm &visual_rhythm);
+
+// To print the frames decoded by the triage and the share of the video it did not decode
+void report_triage(Video &processor);
+
+#endif /* EXTRACTION_H_ */
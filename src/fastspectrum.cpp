@@ -0,0 +1,83 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "fastspectrum.h"
+#include "kernels.h"
+
+#include <cstring>
+#include <stdint.h>
+
+float fast_log(float value) {
+    uint32_t bits = 0;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    // value = mantissa * 2^exponent with mantissa in [1, 2)
+    int exponent = static_cast<int>((bits >> 23) & 0xff) - 127;
+    bits = (bits & 0x007fffff) | 0x3f800000;
+
+    float mantissa = 0.0f;
+    memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    // log2(1 + t) for t in [0, 1) by a least squares polynomial of degree 5
+    float t = mantissa - 1.0f;
+    float log2_mantissa = t * (1.44187990f + t * (-0.70886522f + t * (0.41524556f +
+      t * (-0.19351653f + t * 0.04526829f))));
+
+    return 0.69314718f * (static_cast<float>(exponent) + log2_mantissa);
+}
+
+void fast_log_magnitude(const float *complex_values, float *output, int n, float &min_value,
+  float &max_value) {
+    get_kernels().log_magnitude(complex_values, output, n, min_value, max_value);
+}
+
+void fast_normalize_shift(const Mat &magnitude, Mat &output, float min_value, float max_value,
+  int begin, int end) {
+
+    const KernelTable &kernels = get_kernels();
+    int rows = magnitude.rows;
+    int cols = magnitude.cols;
+    int cx = cols / 2;
+    int cy = rows / 2;
+
+    float range = max_value - min_value;
+    float scale = range > 1e-12f ? 255.0f / range : 0.0f;
+    float shift = 0.5f - min_value * scale;
+
+    for (int y = begin; y < end; y++) {
+        const float *src = magnitude.ptr<float>((y + cy) % rows);
+        uchar *dst = output.ptr<uchar>(y);
+
+        // The swap of the quadrants is a cyclic shift of half the size in both directions
+        kernels.scale_row(src + cx, dst, cols - cx, scale, shift);
+        kernels.scale_row(src, dst + cols - cx, cx, scale, shift);
+    }
+}
@@ -0,0 +1,60 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef FASTSPECTRUM_H_
+#define FASTSPECTRUM_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+using namespace cv;
+
+// Approximate post-processing of the Fourier spectrum, used with -fast_spectrum 1. The exact
+// spectrum is normalize(log(1 + |X|)) computed in double precision. The approximation uses
+// 0.5 * log(1 + |X|^2), which avoids the square root, a polynomial approximation of the
+// logarithm and single precision for the minimum, maximum and scaling. The difference to the
+// exact spectrum is at most log(2)/2 before the normalization (for |X| close to 1) and becomes
+// negligible for large magnitudes; VisualRhythmValidate measures it on real videos.
+
+// To approximate the natural logarithm of a positive float (absolute error below 2e-5)
+float fast_log(float value);
+
+// To compute 0.5 * log(1 + re^2 + im^2) of n interleaved complex values, updating the minimum
+// and maximum values found
+void fast_log_magnitude(const float *complex_values, float *output, int n, float &min_value,
+  float &max_value);
+
+// To scale the rows [begin, end) of the log-magnitude to [0, 255], swapping the quadrants so
+// that the zero frequency is in the center of the spectrum. The magnitude must have even
+// dimensions and the output must have the same size of the magnitude.
+void fast_normalize_shift(const Mat &magnitude, Mat &output, float min_value, float max_value,
+  int begin, int end);
+
+#endif /* FASTSPECTRUM_H_ */
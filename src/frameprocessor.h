@@ -28,6 +28,21 @@ public:
     // To process the input frame and return the result in output frame
     virtual void process(cv::Mat &input, cv::Mat &output){}
 
+    // To get the number of stages the processing of a frame is split into (1 means one stage)
+    virtual int get_stage_number() const { return 1; }
+
+    // To process one stage of a frame, each stage reads the output of the previous one. The
+    // stages may run at the same time on different threads, each stage on one thread only.
+    virtual void process_stage(int stage, cv::Mat &input, cv::Mat &output) {
+        process(input, output);
+    }
+
+    // Has the processor finished before the end of the video? The remaining frames are skipped.
+    virtual bool is_done() { return false; }
+
+    // To process the frames kept by the processor (for example, in a batch) after the last frame
+    virtual void finish() {}
+
     // Destructor
     virtual ~FrameProcessor() {}
 
@@ -0,0 +1,213 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "journal.h"
+#include "checksum.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Largest length of a line of the journal, besides the output file name
+#define JOURNAL_FIELD_LENGTH 96
+
+Journal::Journal() {
+    this->filename = "";
+    this->descriptor = -1;
+}
+
+Journal::~Journal() {
+    close();
+}
+
+bool Journal::open(const string &filename) {
+    close();
+
+    this->filename = filename;
+    this->entries.clear();
+
+    bool is_cut = load();
+
+    this->descriptor = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+
+    if (this->descriptor < 0) {
+        cout << "Error:Journal::open():Could not open " << filename << endl;
+        return false;
+    }
+
+    // A line cut by a crash is ended, so the next line starts at the beginning of a line
+    if (is_cut && ::write(this->descriptor, "\n", 1) != 1) {
+        cout << "Error:Journal::open():Could not write to " << filename << endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void Journal::close() {
+    if (this->descriptor >= 0) {
+        ::close(this->descriptor);
+        this->descriptor = -1;
+    }
+}
+
+bool Journal::is_open() const {
+    return this->descriptor >= 0;
+}
+
+int Journal::get_entry_number() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return static_cast<int>(this->entries.size());
+}
+
+bool Journal::load() {
+    ifstream file(this->filename.c_str(), ios::binary);
+    string line = "";
+    bool is_cut = false;
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    while (getline(file, line)) {
+        uint64_t key = 0;
+        JournalEntry entry;
+
+        // Only the last line of the file may be cut
+        is_cut = file.eof();
+
+        if (parse_line(line, key, entry)) {
+            this->entries[key] = entry;
+        }
+    }
+
+    return is_cut;
+}
+
+bool Journal::parse_line(const string &line, uint64_t &key, JournalEntry &entry) const {
+    unsigned long long line_checksum = 0, checksum = 0, job = 0;
+    long long size = 0;
+    int offset = 0;
+
+    if (sscanf(line.c_str(), "%llx ", &line_checksum) != 1) {
+        return false;
+    }
+
+    // The checksum of the line covers everything after its separator
+    size_t begin = line.find(' ');
+
+    if (begin == string::npos ||
+          compute_checksum(line.data() + begin + 1, line.size() - begin - 1) != line_checksum) {
+        return false;
+    }
+
+    if (sscanf(line.c_str() + begin + 1, "%llx %lld %llx %n", &job, &size, &checksum,
+          &offset) != 3 || offset <= 0) {
+        return false;
+    }
+
+    key = job;
+    entry.output = line.substr(begin + 1 + offset);
+    entry.size = size;
+    entry.checksum = checksum;
+
+    return !entry.output.empty();
+}
+
+bool Journal::is_completed(uint64_t key, const string &output) {
+    JournalEntry entry;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        map<uint64_t, JournalEntry>::const_iterator it = this->entries.find(key);
+
+        if (it == this->entries.end() || it->second.output != output) {
+            return false;
+        }
+
+        entry = it->second;
+    }
+
+    uint64_t checksum = 0;
+    long long size = 0;
+
+    return compute_file_checksum(output, checksum, size) && size == entry.size &&
+      checksum == entry.checksum;
+}
+
+bool Journal::record(uint64_t key, const string &output) {
+    JournalEntry entry;
+
+    entry.output = output;
+
+    if (!compute_file_checksum(output, entry.checksum, entry.size)) {
+        cout << "Error:Journal::record():Could not read " << output << endl;
+        return false;
+    }
+
+    vector<char> fields(JOURNAL_FIELD_LENGTH + output.size());
+    int length = snprintf(&fields[0], fields.size(), "%016llx %lld %016llx %s",
+      static_cast<unsigned long long>(key), entry.size,
+      static_cast<unsigned long long>(entry.checksum), output.c_str());
+
+    char prefix[20];
+    snprintf(prefix, sizeof(prefix), "%016llx ",
+      static_cast<unsigned long long>(compute_checksum(&fields[0], length)));
+
+    string line = string(prefix) + string(&fields[0], length) + "\n";
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->descriptor < 0) {
+        return false;
+    }
+
+    // O_APPEND with a single write keeps the lines of concurrent jobs apart
+    ssize_t written = 0;
+
+    do {
+        written = ::write(this->descriptor, line.data(), line.size());
+    } while (written < 0 && errno == EINTR);
+
+    if (written != static_cast<ssize_t>(line.size())) {
+        cout << "Error:Journal::record():Could not write to " << this->filename << endl;
+        return false;
+    }
+
+    this->entries[key] = entry;
+
+    return true;
+}
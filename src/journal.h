@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+// Output of a job recorded in the journal
+struct JournalEntry {
+
+    // Output file name
+    string output;
+
+    // Size of the output file, in bytes
+    long long size;
+
+    // Checksum of the output file
+    uint64_t checksum;
+
+};
+
+// Class liable for the append-only journal of the jobs of a batch. A line is appended when a
+// job is finished, with the size and the checksum of its output, and a checksum of the line,
+// so that a line cut by a crash is ignored. A job is completed when its last line matches the
+// output file, so outputs written partially, or changed, are computed again. The lines are
+// appended by a single write each, without synchronizing the disk: a line lost in a crash only
+// makes its job be computed again.
+class Journal {
+
+private:
+
+    // Journal file name
+    string filename;
+
+    // Descriptor of the journal file (-1 if closed)
+    int descriptor;
+
+    // Last entry of each job
+    map<uint64_t, JournalEntry> entries;
+
+    // Mutex protecting the entries and the appends
+    std::mutex mutex;
+
+    // To read the lines of an existing journal, returns true if the last line is incomplete
+    bool load();
+
+    // To parse a line of the journal, returns false if it is invalid
+    bool parse_line(const string &line, uint64_t &key, JournalEntry &entry) const;
+
+public:
+
+    // Constructor
+    Journal();
+
+    // Destructor
+    ~Journal();
+
+    // To open (or create) a journal and read its entries
+    bool open(const string &filename);
+
+    // To close the journal
+    void close();
+
+    // Is the journal open?
+    bool is_open() const;
+
+    // To get the number of jobs recorded
+    int get_entry_number();
+
+    // To check whether a job was completed and its output is still the recorded one
+    bool is_completed(uint64_t key, const string &output);
+
+    // To record a completed job, computing the checksum of its output
+    bool record(uint64_t key, const string &output);
+
+};
+
+#endif /* JOURNAL_H_ */
@@ -0,0 +1,153 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "kernels.h"
+
+#include <cstring>
+#include <stdint.h>
+
+// The generic kernels are built without instruction set flags
+namespace kernels_generic {
+#include "kernels_impl.h"
+}
+
+// Level in use, -1 until the kernels are first used
+static int kernel_level = -1;
+
+// Kernels of the level in use
+static KernelTable kernel_table;
+
+void get_kernels_generic(KernelTable &table) {
+    kernels_generic::fill_table(table);
+}
+
+int detect_kernel_level() {
+
+#if defined(__x86_64__) || defined(__i386__)
+    // The builtins run cpuid and check that the system saves the vector registers
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return KERNEL_LEVEL_AVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return KERNEL_LEVEL_AVX2;
+    }
+
+    if (__builtin_cpu_supports("sse4.2")) {
+        return KERNEL_LEVEL_SSE42;
+    }
+#endif
+
+    return KERNEL_LEVEL_GENERIC;
+}
+
+bool set_kernel_level(int level) {
+
+    if (level < KERNEL_LEVEL_GENERIC || level > detect_kernel_level()) {
+        return false;
+    }
+
+    switch (level) {
+        case KERNEL_LEVEL_AVX512:
+            get_kernels_avx512(kernel_table);
+            break;
+        case KERNEL_LEVEL_AVX2:
+            get_kernels_avx2(kernel_table);
+            break;
+        case KERNEL_LEVEL_SSE42:
+            get_kernels_sse42(kernel_table);
+            break;
+        default:
+            get_kernels_generic(kernel_table);
+            break;
+    }
+
+    kernel_level = level;
+
+    return true;
+}
+
+// To choose the detected level, unless a level was forced before
+static bool initialize_kernels() {
+
+    if (kernel_level < 0) {
+        set_kernel_level(detect_kernel_level());
+    }
+
+    return true;
+}
+
+int get_kernel_level() {
+    static bool is_initialized = initialize_kernels();
+
+    (void) is_initialized;
+
+    return kernel_level;
+}
+
+string get_kernel_level_name(int level) {
+    switch (level) {
+        case KERNEL_LEVEL_AVX512:
+            return "avx512";
+        case KERNEL_LEVEL_AVX2:
+            return "avx2";
+        case KERNEL_LEVEL_SSE42:
+            return "sse42";
+        default:
+            return "generic";
+    }
+}
+
+int get_kernel_level_by_name(const string &name) {
+
+    if (name.compare("auto") == 0) {
+        return detect_kernel_level();
+    }
+
+    for (int level = KERNEL_LEVEL_GENERIC; level <= KERNEL_LEVEL_AVX512; level++) {
+        if (name.compare(get_kernel_level_name(level)) == 0) {
+            return level;
+        }
+    }
+
+    return -1;
+}
+
+const KernelTable &get_kernels() {
+
+    // The initialization of a static variable is thread safe, the threads may race here
+    static bool is_initialized = initialize_kernels();
+
+    (void) is_initialized;
+
+    return kernel_table;
+}
@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef KERNELS_H_
+#define KERNELS_H_
+
+#include <string>
+
+using namespace std;
+
+// Instruction set levels of the kernels
+#define KERNEL_LEVEL_GENERIC 0
+#define KERNEL_LEVEL_SSE42 1
+#define KERNEL_LEVEL_AVX2 2
+#define KERNEL_LEVEL_AVX512 3
+
+// Kernels of the hot loops of the visual rhythm. Each kernel is compiled for several instruction
+// set levels (kernels_<level>.cpp, each one with its own compiler flags) and the best level
+// supported by the processor is chosen when the kernels are first used.
+struct KernelTable {
+
+    // To compute 0.5 * log(1 + re^2 + im^2) of n interleaved complex values, updating the
+    // minimum and maximum values found (see fastspectrum.h)
+    void (*log_magnitude)(const float *complex_values, float *output, int n, float &min_value,
+      float &max_value);
+
+    // To compute dst = src * scale + shift converted to 8 bits, for values in [0, 256)
+    void (*scale_row)(const float *src, unsigned char *dst, int n, float scale, float shift);
+
+    // To compute dst = max(a - b, 0) of n 8-bit values, the residual of the noise filtering
+    void (*subtract_row)(const unsigned char *a, const unsigned char *b, unsigned char *dst,
+      int n);
+
+};
+
+// To get the best level supported by the processor
+int detect_kernel_level();
+
+// To force a level, returns false if the processor does not support it. It must be called
+// before the kernels are used by several threads.
+bool set_kernel_level(int level);
+
+// To get the level of the kernels in use
+int get_kernel_level();
+
+// To get the name of a level (generic, sse42, avx2 or avx512)
+string get_kernel_level_name(int level);
+
+// To get the level of a name, auto gives the detected level and -1 means an unknown name
+int get_kernel_level_by_name(const string &name);
+
+// To get the kernels of the level in use
+const KernelTable &get_kernels();
+
+// To fill the table with the kernels of each level (defined in kernels_<level>.cpp)
+void get_kernels_generic(KernelTable &table);
+void get_kernels_sse42(KernelTable &table);
+void get_kernels_avx2(KernelTable &table);
+void get_kernels_avx512(KernelTable &table);
+
+#endif /* KERNELS_H_ */
@@ -0,0 +1,117 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Bodies of the kernels, included by kernels_<level>.cpp inside a namespace of the level. The
+// loops are written so that the compiler vectorizes them with the instruction set given by the
+// flags of each file; this header must not be included anywhere else. The including file must
+// include <cstring> and <stdint.h> before the namespace.
+
+// Number of partial minimums and maximums, enough for the widest vectors (16 floats)
+#define KERNEL_LANES 16
+
+// To approximate the natural logarithm of a positive float (same polynomial of fast_log)
+static inline float log_approx(float value) {
+    uint32_t bits = 0;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    int exponent = static_cast<int>((bits >> 23) & 0xff) - 127;
+    bits = (bits & 0x007fffff) | 0x3f800000;
+
+    float mantissa = 0.0f;
+    memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    float t = mantissa - 1.0f;
+    float log2_mantissa = t * (1.44187990f + t * (-0.70886522f + t * (0.41524556f +
+      t * (-0.19351653f + t * 0.04526829f))));
+
+    return 0.69314718f * (static_cast<float>(exponent) + log2_mantissa);
+}
+
+static void log_magnitude(const float *complex_values, float *output, int n, float &min_value,
+  float &max_value) {
+
+    float lane_min[KERNEL_LANES];
+    float lane_max[KERNEL_LANES];
+    int i = 0;
+
+    for (int l = 0; l < KERNEL_LANES; l++) {
+        lane_min[l] = min_value;
+        lane_max[l] = max_value;
+    }
+
+    // The partial results of each lane keep the reduction out of the vectorized loop
+    for (; i + KERNEL_LANES <= n; i += KERNEL_LANES) {
+        for (int l = 0; l < KERNEL_LANES; l++) {
+            float re = complex_values[2 * (i + l)];
+            float im = complex_values[2 * (i + l) + 1];
+            float value = 0.5f * log_approx(1.0f + re * re + im * im);
+
+            output[i + l] = value;
+            lane_min[l] = value < lane_min[l] ? value : lane_min[l];
+            lane_max[l] = value > lane_max[l] ? value : lane_max[l];
+        }
+    }
+
+    for (; i < n; i++) {
+        float re = complex_values[2 * i];
+        float im = complex_values[2 * i + 1];
+        float value = 0.5f * log_approx(1.0f + re * re + im * im);
+
+        output[i] = value;
+        lane_min[0] = value < lane_min[0] ? value : lane_min[0];
+        lane_max[0] = value > lane_max[0] ? value : lane_max[0];
+    }
+
+    for (int l = 0; l < KERNEL_LANES; l++) {
+        min_value = lane_min[l] < min_value ? lane_min[l] : min_value;
+        max_value = lane_max[l] > max_value ? lane_max[l] : max_value;
+    }
+}
+
+static void scale_row(const float *src, unsigned char *dst, int n, float scale, float shift) {
+    for (int i = 0; i < n; i++) {
+        dst[i] = static_cast<unsigned char>(static_cast<int>(src[i] * scale + shift));
+    }
+}
+
+static void subtract_row(const unsigned char *a, const unsigned char *b, unsigned char *dst,
+  int n) {
+    for (int i = 0; i < n; i++) {
+        dst[i] = a[i] > b[i] ? static_cast<unsigned char>(a[i] - b[i]) : 0;
+    }
+}
+
+// To fill a table with the kernels of this file
+static void fill_table(KernelTable &table) {
+    table.log_magnitude = log_magnitude;
+    table.scale_row = scale_row;
+    table.subtract_row = subtract_row;
+}
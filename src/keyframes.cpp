@@ -0,0 +1,300 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "keyframes.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+// Flag of the keyframes in the entries of the idx1 chunk of AVI files
+#define AVI_KEYFRAME_FLAG 0x10
+
+// Video track of a MP4 file found while walking its boxes
+struct Mp4Track {
+    bool is_video;
+    bool has_sync_table;
+    uint32_t sample_number;
+    vector<long> sync_samples;
+};
+
+static bool read_little_endian(istream &stream, uint32_t &value) {
+    unsigned char bytes[4];
+
+    if (!stream.read(reinterpret_cast<char*>(bytes), 4)) {
+        return false;
+    }
+
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+static bool read_big_endian(istream &stream, uint32_t &value) {
+    unsigned char bytes[4];
+
+    if (!stream.read(reinterpret_cast<char*>(bytes), 4)) {
+        return false;
+    }
+
+    value = (static_cast<uint32_t>(bytes[0]) << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+    return true;
+}
+
+static bool read_tag(istream &stream, char tag[5]) {
+    tag[4] = '\0';
+    return static_cast<bool>(stream.read(tag, 4));
+}
+
+// To find the number of the first video stream in the hdrl list of an AVI file
+static int find_avi_video_stream(istream &file, uint64_t end) {
+    int stream = 0;
+    char tag[5], type[5];
+    uint32_t size = 0;
+
+    while (static_cast<uint64_t>(file.tellg()) + 8 <= end && read_tag(file, tag) &&
+          read_little_endian(file, size)) {
+
+        uint64_t next = static_cast<uint64_t>(file.tellg()) + size + (size & 1);
+
+        if (strcmp(tag, "LIST") == 0 && read_tag(file, type) && strcmp(type, "strl") == 0) {
+
+            // The stream header is the first chunk of the stream list
+            if (read_tag(file, tag) && strcmp(tag, "strh") == 0 && read_little_endian(file, size) &&
+                  read_tag(file, type) && strcmp(type, "vids") == 0) {
+                return stream;
+            }
+
+            stream++;
+        }
+
+        file.seekg(next);
+    }
+
+    return -1;
+}
+
+static bool read_avi_keyframes(istream &file, vector<long> &keyframes) {
+    char tag[5], type[5];
+    uint32_t size = 0;
+    int stream = -1;
+
+    file.seekg(12);
+
+    while (read_tag(file, tag) && read_little_endian(file, size)) {
+        uint64_t begin = file.tellg();
+        uint64_t next = begin + size + (size & 1);
+
+        if (strcmp(tag, "LIST") == 0 && read_tag(file, type) && strcmp(type, "hdrl") == 0) {
+            stream = find_avi_video_stream(file, begin + size);
+        } else if (strcmp(tag, "idx1") == 0 && stream >= 0) {
+            char prefix[3] = { static_cast<char>('0' + stream / 10),
+              static_cast<char>('0' + stream % 10), '\0' };
+            long frame = 0;
+            uint32_t flags = 0, offset = 0, length = 0;
+
+            // Entries of 16 bytes: chunk id, flags, offset and size; the video chunks are ##dc
+            // (compressed) or ##db (uncompressed)
+            for (uint32_t i = 0; i < size / 16; i++) {
+                if (!read_tag(file, tag) || !read_little_endian(file, flags) ||
+                      !read_little_endian(file, offset) || !read_little_endian(file, length)) {
+                    return false;
+                }
+
+                if (strncmp(tag, prefix, 2) != 0 || (tag[2] != 'd' || (tag[3] != 'c' &&
+                      tag[3] != 'b'))) {
+                    continue;
+                }
+
+                if (flags & AVI_KEYFRAME_FLAG) {
+                    keyframes.push_back(frame);
+                }
+
+                frame++;
+            }
+
+            return frame > 0;
+        }
+
+        file.clear();
+        file.seekg(next);
+    }
+
+    return false;
+}
+
+// To walk the boxes in [begin, end), descending into the boxes that contain the sample tables
+static bool walk_mp4_boxes(istream &file, uint64_t begin, uint64_t end, Mp4Track &track,
+  vector<Mp4Track> &tracks) {
+
+    uint64_t position = begin;
+
+    while (position + 8 <= end) {
+        uint32_t size32 = 0, value = 0;
+        char tag[5];
+        uint64_t size = 0, header = 8;
+
+        file.seekg(position);
+
+        if (!read_big_endian(file, size32) || !read_tag(file, tag)) {
+            return false;
+        }
+
+        size = size32;
+
+        if (size32 == 1) {
+            uint32_t high = 0, low = 0;
+
+            if (!read_big_endian(file, high) || !read_big_endian(file, low)) {
+                return false;
+            }
+
+            size = (static_cast<uint64_t>(high) << 32) | low;
+            header = 16;
+        } else if (size32 == 0) {
+            size = end - position;
+        }
+
+        if (size < header || position + size > end) {
+            return false;
+        }
+
+        uint64_t data = position + header;
+
+        if (strcmp(tag, "trak") == 0) {
+            Mp4Track trak = { false, false, 0, vector<long>() };
+
+            if (!walk_mp4_boxes(file, data, position + size, trak, tracks)) {
+                return false;
+            }
+
+            tracks.push_back(trak);
+        } else if (strcmp(tag, "moov") == 0 || strcmp(tag, "mdia") == 0 ||
+              strcmp(tag, "minf") == 0 || strcmp(tag, "stbl") == 0) {
+
+            if (!walk_mp4_boxes(file, data, position + size, track, tracks)) {
+                return false;
+            }
+        } else if (strcmp(tag, "hdlr") == 0) {
+
+            // Version and flags, pre-defined, then the handler type
+            file.seekg(data + 8);
+            track.is_video = read_tag(file, tag) && strcmp(tag, "vide") == 0;
+        } else if (strcmp(tag, "stsz") == 0) {
+
+            // Version and flags, sample size, then the number of samples
+            file.seekg(data + 8);
+
+            if (!read_big_endian(file, track.sample_number)) {
+                return false;
+            }
+        } else if (strcmp(tag, "stss") == 0) {
+            uint32_t entries = 0;
+
+            file.seekg(data + 4);
+
+            if (!read_big_endian(file, entries) || entries > (size - header) / 4) {
+                return false;
+            }
+
+            track.has_sync_table = true;
+
+            // The samples are numbered from 1
+            for (uint32_t i = 0; i < entries; i++) {
+                if (!read_big_endian(file, value)) {
+                    return false;
+                }
+
+                track.sync_samples.push_back(static_cast<long>(value) - 1);
+            }
+        }
+
+        position += size;
+    }
+
+    return true;
+}
+
+static bool read_mp4_keyframes(istream &file, uint64_t size, vector<long> &keyframes) {
+    Mp4Track root = { false, false, 0, vector<long>() };
+    vector<Mp4Track> tracks;
+
+    if (!walk_mp4_boxes(file, 0, size, root, tracks)) {
+        return false;
+    }
+
+    for (size_t t = 0; t < tracks.size(); t++) {
+        const Mp4Track &track = tracks[t];
+
+        if (!track.is_video || track.sample_number == 0) {
+            continue;
+        }
+
+        if (!track.has_sync_table) {
+            for (uint32_t i = 0; i < track.sample_number; i++) {
+                keyframes.push_back(i);
+            }
+        } else {
+            keyframes = track.sync_samples;
+        }
+
+        return !keyframes.empty();
+    }
+
+    return false;
+}
+
+bool read_keyframes(const string &filename, vector<long> &keyframes) {
+    ifstream file(filename.c_str(), ios::binary);
+    char header[12];
+
+    keyframes.clear();
+
+    if (!file.is_open() || !file.read(header, sizeof(header))) {
+        return false;
+    }
+
+    if (memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "AVI ", 4) == 0) {
+        return read_avi_keyframes(file, keyframes);
+    }
+
+    // The first box of MP4 and QuickTime files is usually ftyp, but may also be moov or free
+    if (memcmp(header + 4, "ftyp", 4) == 0 || memcmp(header + 4, "moov", 4) == 0 ||
+          memcmp(header + 4, "free", 4) == 0 || memcmp(header + 4, "mdat", 4) == 0 ||
+          memcmp(header + 4, "wide", 4) == 0) {
+
+        file.seekg(0, ios::end);
+        uint64_t size = file.tellg();
+
+        file.clear();
+        return read_mp4_keyframes(file, size, keyframes);
+    }
+
+    return false;
+}
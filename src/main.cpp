@@ -28,41 +28,18 @@
     OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 \*------------------------------------------------------------------------------------------------*/
 
-#include "video.h"
-#include "visualrhythm.h"
-#include <sys/stat.h>
-#include <errno.h>
-
-void compute_visual_rhythm(int color_space, int filter, int frame_number, string input_video,
-  int kernel_size, string output_image, int roi_width, float variance,
-  int visual_rhythm_type);
-
-int create_path(string str, mode_t mode);
-
-void help(string filename);
-
-bool is_number(string str);
-
-void parse_command_line(int argc, char **argv, int &color_space, int &filter, int &frame_number,
-  string &input_video, int &kernel_size, string &output_image, int &roi_width,
-  float &variance, int &visual_rhythm_type);
-
-void split_filename(string str, string &path, string &file, string &extension);
-
-bool verify_command_line(int color_space, int filter, int frame_number, string input_video,
-  int kernel_size, string &output_image, int roi_width, float variance, int visual_rhythm_type);
+#include "extraction.h"
+#include "kernels.h"
+#include "parameters.h"
+#include "resultcache.h"
+#include "scheduler.h"
+#include "server.h"
+#include "tracer.h"
 
 int main(int argc, char** argv) {
 
-    int color_space = 0;
-    int filter = 0;
-    int frame_number = 50;
-    string input_video = "";
-    int kernel_size = 7;
-    string output_image = "";
-    int roi_width = 30;
-    float variance = 2;
-    int visual_rhythm_type = -99;
+    Parameters parameters;
+    bool is_missing_parameter = false;
 
     bool is_opencv_version = false;
 
@@ -90,458 +67,129 @@ int main(int argc, char** argv) {
         exit(EXIT_FAILURE);
     }
 
-    parse_command_line(argc, argv, color_space, filter, frame_number, input_video, kernel_size, 
-      output_image, roi_width, variance, visual_rhythm_type);
-
-    compute_visual_rhythm(color_space, filter, frame_number, input_video, kernel_size, 
-      output_image, roi_width, variance, visual_rhythm_type);
-
-    return 0;
-}
-
-void compute_visual_rhythm(int color_space, int filter, int frame_number, 
-  string input_video, int kernel_size, string output_image, int roi_width,
-  float variance, int visual_rhythm_type) {
-
-    //Object liable for control of the video
-    Video processor;
-
-    //Object liable for processing of each frame
-    VisualRhythm visual_rhythm;
-
-    processor.set_input_video(input_video.c_str());
-    processor.set_frame_processor(&visual_rhythm);
-    processor.set_frame_to_stop(frame_number);
-
-    visual_rhythm.set_visual_rhythm_type(visual_rhythm_type);
-    visual_rhythm.set_color_space(color_space);
-    visual_rhythm.set_filter(filter);
-    visual_rhythm.set_kernel_size(kernel_size);
-    visual_rhythm.set_variance(variance);
-    visual_rhythm.set_width(roi_width);
-    visual_rhythm.set_output_filename(output_image.c_str());
-
-    if (visual_rhythm_type == 0) {
-        cout << "Extracting vertical visual rhythm ... ";
-
-        int height_vertical = processor.get_frame_height();
-        visual_rhythm.set_height(height_vertical);
-        visual_rhythm.set_visual_rhythm(Mat(height_vertical, roi_width * frame_number, CV_8U));
-        processor.run();
-        cout << "Ok!" << endl;
-
-        cout << "Saving the generated visual rhythm ... ";
-        visual_rhythm.save_visual_rhythm();
-        cout << "Ok!" << endl;
-    } else if (visual_rhythm_type == 1) {
-        cout << "Extracting horizontal visual rhythm ... ";
-
-        int height_horizontal = processor.get_frame_width();
-        visual_rhythm.set_height(height_horizontal);
-        visual_rhythm.set_visual_rhythm(Mat(height_horizontal,roi_width * frame_number, CV_8U));
-        processor.run();
-        cout << "Ok!" << endl;
-
-        cout << "Saving the generated visual rhythm ... ";
-        visual_rhythm.save_visual_rhythm();
-        cout << "Ok!" << endl;
-    } else if (visual_rhythm_type == 2) {
-        cout << "Extracting zig-zag visual rhythm ... ";
-
-        int height = processor.get_frame_height();
-        int width = processor.get_frame_width();
-        int height_zigzag = visual_rhythm.compute_dimensions_visual_rhythm(height, width);
-
-        visual_rhythm.set_height(height_zigzag);
-        visual_rhythm.set_visual_rhythm(Mat(height_zigzag, roi_width * frame_number, CV_8U));
-        processor.run();
-        cout << "Ok!" << endl;
-
-        cout << "Saving the generated visual rhythm ... ";
-        visual_rhythm.save_visual_rhythm();
-        cout << "Ok!" << endl;
-    } else {
-        cout << "Invalid type for visual rhythm!";
+    if ((argc > 1) && (string(argv[1]).compare(0, 6, "--help") == 0)) {
+        help(string(argv[0]));
         exit(EXIT_FAILURE);
     }
 
-    cout << "Done!\n" << endl;
-}
+    is_missing_parameter = parse_command_line(argc, argv, parameters);
 
-int create_path(string str, mode_t mode){
-    size_t pre = 0, pos;
-    string dir;
-    int mdret;
+    if (!is_missing_parameter) {
+        int kernel_level = get_kernel_level_by_name(parameters.cpu_level);
 
-    if (str[str.size()-1]!='/') {
-        str += '/';
-    }
-
-    while ((pos = str.find_first_of('/', pre)) != string::npos) {
-        dir = str.substr(0, pos++);
-        pre = pos;
-
-        if (dir.size() == 0) {
-            continue;
+        if (kernel_level < 0) {
+            cout << "Invalid value used in cpu_level. See --help" << endl;
+            exit(EXIT_FAILURE);
         }
 
-        if ((mdret = mkdir(dir.c_str(), mode)) && errno != EEXIST) {
-            return mdret;
+        if (!set_kernel_level(kernel_level)) {
+            cout << "The processor does not support the cpu_level " << parameters.cpu_level;
+            cout << ". See --help" << endl;
+            exit(EXIT_FAILURE);
         }
-    }
-
-    return mdret;
-}
-
-void help(string filename){
-
-    string path = "";
-    string program_name = "";
-    string extension = "";
-
-    split_filename(filename, path, program_name, extension);
-
-    cout << program_name << " (Version 1.0.0)" << endl;
-
-    cout << "" << endl;
-
-    cout << "New BSD License." << endl;
-    cout << "Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, " << endl;
-    cout << "and Anderson Rocha" << endl;
-    cout << "All rights reserved." << endl;
 
-    cout << "" << endl;
-
-    cout << "Usage: " << program_name << " [-option [value]] " << endl;
-
-    cout << "" << endl;
-
-    cout << "Options:" << endl;
-
-    cout << "  -color_space\t\t Integer between 0 and 1 that indicates the color space used ";
-    cout << "to load the video frames (default=0). Use:" << endl;
-    cout << "   \t\t\t   0: To load the frames in grayscale" << endl;
-    cout << "   \t\t\t   1: To load the frames in the Lab color space" << endl;
-
-    cout << "  -filter\t\t Integer between 0 and 1 that indicates the type of filter used ";
-    cout << "to compute the residual noise video (default=0). Use:" << endl;
-    cout << "   \t\t\t   0: To use a Median filter" << endl;
-    cout << "   \t\t\t   1: To use a Gaussian filter" << endl;
-
-    cout << "  -frame_number\t\t Positive integer that indicates the number of consecutive frames ";
-    cout << "used during computation of the visual rhythm (default=50)." << endl;
-
-    cout << "  -input_video\t\t Filename of the input video to be computed the ";
-    cout << "visual rhythm <required>." << endl;
-
-    cout << "  -kernel_size\t\t Positive odd integer that indicates the size of the ";
-    cout << "kernel used during filtering of the input video (default=7)." << endl;
-
-    cout << "  -output_image\t\t Filename of the computed visual rhythm. Visual rhythm is saved ";
-    cout << "as PNG image file <required>." << endl;
-
-    cout << "  -roi_width\t\t Positive integer that indicates the width of the ";
-    cout << "region of interesting extracted of each frames (default=30)." << endl;
-
-    cout << "  -variance\t\t Float that indicates the variance of the ";
-    cout << "Gaussian filter (default=2)." << endl;
-
-    cout << "  -visual_rhythm_type\t Integer between 0 and 2 that indicates the ";
-    cout << "type of visual rhythm to be computed from input video <required>. Use:" << endl;
-    cout << "   \t\t\t   0: To compute a vertical visual rhythm" << endl;
-    cout << "   \t\t\t   1: To compute a horizontal visual rhythm" << endl;
-    cout << "   \t\t\t   2: To compute a zig-zag visual rhythm" << endl;
-
-    cout << "" << endl;
-
-    cout << "Examples: See README." << endl;
-
-    cout << "" << endl;
-
-    cout << "News, support and information: ";
-    cout << "https://github.com/allansp84/visualrhythm-antispoofing" << endl;
-
-}
-
-bool is_number(string str) {
-    string::const_iterator it = str.begin();
-
-    while (it != str.end() && isdigit(*it)){
-        ++it;
+        if (parameters.verbose) {
+            cout << "Kernel level: " << get_kernel_level_name(get_kernel_level()) << endl;
+        }
     }
 
-    return !str.empty() && it == str.end();
-}
-
-void parse_command_line(int argc, char **argv, int &color_space, int &filter, int &frame_number,
-  string &input_video, int &kernel_size, string &output_image, int &roi_width,
-  float &variance, int &visual_rhythm_type) {
-
-    int i = 1;
-    bool is_missing_parameter = false;
-
-    string help_pattern = "--help";
-    string visual_rhythm_type_pattern = "-visual_rhythm_type";
-    string frame_number_pattern = "-frame_number";
-    string roi_width_pattern = "-roi_width";
-    string filter_pattern = "-filter";
-    string kernel_size_pattern = "-kernel_size";
-    string variance_pattern = "-variance";
-    string color_space_pattern = "-color_space";
-    string input_video_pattern = "-input_video";
-    string output_image_pattern = "-output_image";
-
-    if (help_pattern.compare(0, help_pattern.length(), argv[i], help_pattern.length()) == 0) {
-        help(string(argv[0]));
-        exit(EXIT_FAILURE);
+    if (!is_missing_parameter && !parameters.trace.empty()) {
+        start_tracing(parameters.trace);
+        set_trace_thread_name("Main");
     }
 
-    while ((i < argc) && (is_missing_parameter == false)) {
-
-        if (output_image_pattern.compare(0, output_image_pattern.length(), argv[i],
-              output_image_pattern.length()) == 0) {
-
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << output_image_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else {
-                output_image = string(argv[i]);
-            }
-
-        } else if (roi_width_pattern.compare(0, roi_width_pattern.length(), argv[i],
-              roi_width_pattern.length()) == 0) {
+    if (!is_missing_parameter && !parameters.server_socket.empty()) {
 
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << roi_width_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else if (is_number(argv[i])) {
-                roi_width = atoi(argv[i]);
-            } else {
-                cout << "Missing value for parameter " << roi_width_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            }
-
-        } else if (kernel_size_pattern.compare(0, kernel_size_pattern.length(), argv[i],
-              kernel_size_pattern.length()) == 0) {
-
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << kernel_size_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else if (is_number(argv[i])) {
-                kernel_size = atoi(argv[i]);
-            } else {
-                cout << "Missing value for parameter " << kernel_size_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            }
-
-        } else if (variance_pattern.compare(0, variance_pattern.length(), argv[i],
-              variance_pattern.length()) == 0) {
-
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << variance_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else if (is_number(argv[i])) {
-                variance = atof(argv[i]);
-            } else {
-                cout << "Missing value for parameter " << variance_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            }
-
-        } else if (color_space_pattern.compare(0, color_space_pattern.length(), argv[i],
-              color_space_pattern.length()) == 0) {
+        if (parameters.server_workers < 1) {
+            cout << "Invalid value used in server_workers. See --help" << endl;
+            exit(EXIT_FAILURE);
+        }
 
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << color_space_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else if (is_number(argv[i])) {
-                color_space = atoi(argv[i]);
-            } else {
-                cout << "Missing value for parameter " << color_space_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            }
+        if (parameters.threads < 1) {
+            cout << "Invalid value used in threads. See --help" << endl;
+            exit(EXIT_FAILURE);
+        }
 
-        } else if (visual_rhythm_type_pattern.compare(0, visual_rhythm_type_pattern.length(),
-              argv[i], visual_rhythm_type_pattern.length()) == 0) {
+        Server server;
+        server.set_socket_path(parameters.server_socket);
+        server.set_worker_number(parameters.server_workers);
+        server.set_thread_number(parameters.threads);
 
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << visual_rhythm_type_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else if (is_number(argv[i])) {
-                visual_rhythm_type = atoi(argv[i]);
-            } else {
-                cout << "Missing value for parameter " << visual_rhythm_type_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            }
+        if (!server.run()) {
+            exit(EXIT_FAILURE);
+        }
 
-        } else if (frame_number_pattern.compare(0, frame_number_pattern.length(), argv[i],
-              frame_number_pattern.length()) == 0) {
+        return 0;
+    }
 
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << frame_number_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else if (is_number(argv[i])) {
-                frame_number = atoi(argv[i]);
-            } else {
-                cout << "Missing value for parameter " << frame_number_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            }
+    if (!is_missing_parameter && !parameters.batch.empty()) {
 
-        } else if (filter_pattern.compare(0, filter_pattern.length(), argv[i],
-              filter_pattern.length()) == 0) {
+        if (parameters.threads < 1) {
+            cout << "Invalid value used in threads. See --help" << endl;
+            exit(EXIT_FAILURE);
+        }
 
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << filter_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else if (is_number(argv[i])) {
-                filter = atoi(argv[i]);
-            } else {
-                cout << "Missing value for parameter " << filter_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            }
+        Scheduler scheduler;
+        scheduler.set_core_number(parameters.threads);
+        scheduler.set_pinning(parameters.pin_threads == 1);
+        scheduler.set_verbose(parameters.verbose);
+        scheduler.set_journal(parameters.journal);
+        scheduler.set_dataset(parameters.dataset);
 
-        } else if (input_video_pattern.compare(0, input_video_pattern.length(), argv[i],
-              input_video_pattern.length()) == 0) {
+        if (!parameters.shard.empty()) {
+            int shard_index = 0, shard_number = 1;
 
-            i++;
-            if ((argv[i]) == NULL) {
-                cout << "Missing value for parameter " << input_video_pattern;
-                cout << ". See --help." << endl;
-                is_missing_parameter = true;
-            } else {
-                input_video = string(argv[i]);
+            if (!parse_shard(parameters.shard, shard_index, shard_number)) {
+                cout << "Invalid value used in shard. See --help" << endl;
+                exit(EXIT_FAILURE);
             }
 
-        } else {
-
-            cout << "Warning:parse_command_line():unknown parameter " << argv[i];
-            cout << ". See --help." << endl;
-            is_missing_parameter = true;
-
+            scheduler.set_shard(shard_index, shard_number);
         }
 
-        i++;
+        if (!scheduler.load_manifest(parameters.batch, parameters) || !scheduler.run()) {
+            exit(EXIT_FAILURE);
+        }
 
+        return 0;
     }
 
-    if (!is_missing_parameter){
-        is_missing_parameter = verify_command_line(color_space, filter, frame_number, input_video,
-          kernel_size, output_image, roi_width, variance, visual_rhythm_type);
+    if (!is_missing_parameter) {
+        is_missing_parameter = verify_command_line(parameters);
     }
 
     if (is_missing_parameter) {
         exit(EXIT_FAILURE);
     }
 
-}
-
-void split_filename(string str, string &path, string &file, string &extension) {
-
-    size_t found = str.find_last_of("/\\");
-    size_t last_dot = str.find_last_of(".");
-
-    if (found != string::npos) {
-        path = str.substr(0,found);
-        file = str.substr(found+1);
-
-    } else {
-        file = str;
-    }
-
-    if (last_dot != string::npos) {
-        extension = str.substr(last_dot+1);
-    }
-
-}
-
-bool verify_command_line(int color_space, int filter, int frame_number, string input_video,
-  int kernel_size, string &output_image, int roi_width, float variance, int visual_rhythm_type){
-
-    bool is_missing_parameter = false;
-    struct stat file_stat;
+    //Key of the result, to skip the extraction of an unchanged video
+    ResultKey result_key;
 
-    string path = "";
-    string file = "";
-    string extension = "";
-
-    if ((visual_rhythm_type < 0) || (visual_rhythm_type > 2)) {
-        cout << "Invalid value used in visual_rhythm_type. See --help" << endl;
-        is_missing_parameter = true;
-    }
-
-    if (frame_number < 1) {
-        cout << "Invalid value used in frame_number. See --help" << endl;
-        is_missing_parameter = true;
-    }
-
-    if (roi_width < 1) {
-        cout << "Invalid value used in roi_width. See --help" << endl;
-        is_missing_parameter = true;
-    }
-
-    if ((filter < 0) || (filter > 1)) {
-        cout << "Invalid value used in filter. See --help" << endl;
-        is_missing_parameter = true;
-    }
-
-    if ((kernel_size < 3) || (kernel_size % 2 == 0)) {
-        cout << "Invalid value used in kernel_size. See --help" << endl;
-        is_missing_parameter = true;
-    }
-
-    if (variance < 0) {
-        cout << "Invalid value used in variance. See --help" << endl;
-        is_missing_parameter = true;
-    }
-
-    if ((color_space < 0) || (color_space > 1)) {
-        cout << "Invalid value used in color_space. See --help" << endl;
-        is_missing_parameter = true;
+    if (parameters.cache == 1 && is_cached_result(parameters, result_key)) {
+        if (parameters.verbose) {
+            cout << parameters.output_image << " is up to date" << endl;
+        }
+        return 0;
     }
 
-    if (lstat(input_video.c_str(), &file_stat) == -1) {
-        fprintf(stderr, "%s\n", strerror(errno));
-        cout << "Invalid value used in input_video. See --help" << endl;
-        is_missing_parameter = true;
-    }
+    //Object liable for control of the video
+    Video processor;
 
-    split_filename(output_image, path, file, extension);
+    //Object liable for processing of each frame
+    VisualRhythm visual_rhythm;
 
-    if (file.empty()) {
-        cout << "Invalid file name used in output_image. See --help" << endl;
-        is_missing_parameter = true;
-    }
+    //Threads used to compute each frame
+    ThreadPool thread_pool;
+    thread_pool.start(parameters.threads);
+    visual_rhythm.set_thread_pool(&thread_pool);
 
-    if (extension.empty() || extension.compare("png")) {
-        output_image += ".png";
+    if (!compute_visual_rhythm(parameters, processor, visual_rhythm)) {
+        exit(EXIT_FAILURE);
     }
 
-    if (!path.empty()) {
-        create_path(path, 0755);
+    if (parameters.cache == 1 && !record_result(parameters, result_key)) {
+        exit(EXIT_FAILURE);
     }
 
-    return is_missing_parameter;
-
+    return 0;
 }
@@ -0,0 +1,1168 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "parameters.h"
+#include "kernels.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <errno.h>
+
+Parameters::Parameters() {
+    this->color_space = 0;
+    this->filter = 0;
+    this->frame_number = 50;
+    this->input_video = "";
+    this->kernel_size = 7;
+    this->output_image = "";
+    this->roi_width = 30;
+    this->variance = 2;
+    this->visual_rhythm_type = -99;
+    this->server_socket = "";
+    this->server_workers = 4;
+    this->threads = 1;
+    this->fast_spectrum = 0;
+    this->streaming_output = 0;
+    this->pipeline = 0;
+    this->batch = "";
+    this->pin_threads = 0;
+    this->score_model = "";
+    this->score_interval = 15;
+    this->accept_threshold = 1.0;
+    this->reject_threshold = -1.0;
+    this->cpu_level = "auto";
+    this->journal = "";
+    this->shard = "";
+    this->dataset = "";
+    this->trace = "";
+    this->window_length = 0;
+    this->window_stride = 0;
+    this->max_windows = 0;
+    this->spectrum_batch = 1;
+    this->row_fusion = 0;
+    this->triage = 0;
+    this->cache = 0;
+    this->row_statistics = 0;
+    this->skip_duplicates = 0;
+    this->verbose = true;
+}
+
+int create_path(string str, mode_t mode){
+    size_t pre = 0, pos;
+    string dir;
+    int mdret;
+
+    if (str[str.size()-1]!='/') {
+        str += '/';
+    }
+
+    while ((pos = str.find_first_of('/', pre)) != string::npos) {
+        dir = str.substr(0, pos++);
+        pre = pos;
+
+        if (dir.size() == 0) {
+            continue;
+        }
+
+        if ((mdret = mkdir(dir.c_str(), mode)) && errno != EEXIST) {
+            return mdret;
+        }
+    }
+
+    return mdret;
+}
+
+void help(string filename){
+
+    string path = "";
+    string program_name = "";
+    string extension = "";
+
+    split_filename(filename, path, program_name, extension);
+
+    cout << program_name << " (Version 1.0.0)" << endl;
+
+    cout << "" << endl;
+
+    cout << "New BSD License." << endl;
+    cout << "Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, " << endl;
+    cout << "and Anderson Rocha" << endl;
+    cout << "All rights reserved." << endl;
+
+    cout << "" << endl;
+
+    cout << "Usage: " << program_name << " [-option [value]] " << endl;
+
+    cout << "" << endl;
+
+    cout << "Options:" << endl;
+
+    cout << "  -accept_threshold\t Float that indicates the score above which an early decision of a ";
+    cout << "genuine access is taken (default=1.0)." << endl;
+
+    cout << "  -batch\t\t Filename of a manifest with one video per line, each line with the ";
+    cout << "options of the video. The threads are shared by the videos of the batch." << endl;
+
+    cout << "  -cache\t\t Integer between 0 and 1 that indicates whether the extraction is ";
+    cout << "skipped when the video and the parameters did not change (default=0)." << endl;
+
+    cout << "  -color_space\t\t Integer between 0 and 1 that indicates the color space used ";
+    cout << "to load the video frames (default=0). Use:" << endl;
+    cout << "   \t\t\t   0: To load the frames in grayscale" << endl;
+    cout << "   \t\t\t   1: To load the frames in the Lab color space" << endl;
+
+    cout << "  -cpu_level\t\t Instruction set level of the kernels: auto, generic, sse42, avx2 or ";
+    cout << "avx512 (default=auto)." << endl;
+
+    cout << "  -dataset\t\t Filename of a dataset container written with the visual rhythms ";
+    cout << "of a batch (or of its shard)." << endl;
+
+    cout << "  -fast_spectrum\t Integer between 0 and 1 that indicates whether the Fourier ";
+    cout << "spectrum is approximated, trading accuracy for speed (default=0)." << endl;
+
+    cout << "  -filter\t\t Integer between 0 and 2 that indicates the type of filter used ";
+    cout << "to compute the residual noise video (default=0). Use:" << endl;
+    cout << "   \t\t\t   0: To use a Median filter" << endl;
+    cout << "   \t\t\t   1: To use a Gaussian filter" << endl;
+    cout << "   \t\t\t   2: To use a recursive approximation of the Gaussian filter, whose cost ";
+    cout << "does not depend on the variance (kernel_size is not used)" << endl;
+
+    cout << "  -frame_number\t\t Positive integer that indicates the number of consecutive frames ";
+    cout << "used during computation of the visual rhythm (default=50)." << endl;
+
+    cout << "  -input_video\t\t Filename of the input video to be computed the ";
+    cout << "visual rhythm <required>." << endl;
+
+    cout << "  -journal\t\t Filename of the journal of a batch. The videos completed by a ";
+    cout << "previous run of the batch are not computed again." << endl;
+
+    cout << "  -kernel_size\t\t Positive odd integer that indicates the size of the ";
+    cout << "kernel used during filtering of the input video (default=7)." << endl;
+
+    cout << "  -max_windows\t\t Non-negative integer that indicates the largest number of windows ";
+    cout << "computed from a video (default=0, all windows of the video)." << endl;
+
+    cout << "  -output_image\t\t Filename of the computed visual rhythm. Visual rhythm is saved ";
+    cout << "as PNG image file <required>." << endl;
+
+    cout << "  -pin_threads\t\t Integer between 0 and 1 that indicates whether the threads of ";
+    cout << "each video of a batch are pinned to cores (default=0)." << endl;
+
+    cout << "  -pipeline\t\t Integer between 0 and 1 that indicates whether the stages of each ";
+    cout << "frame run on their own threads (default=0)." << endl;
+
+    cout << "  -reject_threshold\t Float that indicates the score below which an early decision of an ";
+    cout << "attack is taken (default=-1.0)." << endl;
+
+    cout << "  -roi_width\t\t Positive integer that indicates the width of the ";
+    cout << "region of interesting extracted of each frames (default=30)." << endl;
+
+    cout << "  -row_fusion\t\t Integer between 0 and 1 that indicates whether the noise image and ";
+    cout << "the row pass of the Fourier transform are computed together (default=0)." << endl;
+
+    cout << "  -row_statistics\t Integer between 0 and 1 that indicates whether only the ";
+    cout << "statistics of each row over time are kept and saved as a text descriptor ";
+    cout << "(default=0)." << endl;
+
+    cout << "  -score_interval\t Positive integer that indicates the number of frames between two ";
+    cout << "evaluations of the score (default=15)." << endl;
+
+    cout << "  -score_model\t\t Filename of a linear model scoring the partial visual rhythm. The ";
+    cout << "extraction stops when the score crosses one of the thresholds." << endl;
+
+    cout << "  -server_socket\t Path of a Unix socket where the program waits for extraction ";
+    cout << "requests instead of computing a single visual rhythm." << endl;
+
+    cout << "  -server_workers\t Positive integer that indicates the number of requests ";
+    cout << "processed at the same time by the server (default=4)." << endl;
+
+    cout << "  -shard\t\t Shard of a batch computed by this process, given as i/N, with ";
+    cout << "0 <= i < N. The videos are assigned to the shards by the checksum of their lines.";
+    cout << endl;
+
+    cout << "  -skip_duplicates\t Integer between 0 and 1 that indicates whether a frame ";
+    cout << "identical to the previous one reuses its strip (default=0)." << endl;
+
+    cout << "  -spectrum_batch\t Integer between 1 and 64 that indicates the number of frames whose ";
+    cout << "Fourier spectra are computed together (default=1)." << endl;
+
+    cout << "  -streaming_output\t Integer between 0 and 1 that indicates whether the strips are ";
+    cout << "written to the output file as they are computed, as a transposed PGM image ";
+    cout << "(default=0)." << endl;
+
+    cout << "  -threads\t\t Positive integer that indicates the number of threads used to ";
+    cout << "compute each frame, splitting it in bands of rows (default=1)." << endl;
+
+    cout << "  -trace\t\t Filename of a timeline of the frames, written at the exit of the ";
+    cout << "program in the trace-event JSON format of Chrome and Perfetto." << endl;
+
+    cout << "  -triage\t\t Integer between 0 and 1 that indicates whether only the keyframes ";
+    cout << "are read, for a fast triage with a different descriptor (default=0)." << endl;
+
+    cout << "  -variance\t\t Float that indicates the variance of the ";
+    cout << "Gaussian filter (default=2)." << endl;
+
+    cout << "  -visual_rhythm_type\t Integer between 0 and 2 that indicates the ";
+    cout << "type of visual rhythm to be computed from input video <required>. Use:" << endl;
+    cout << "   \t\t\t   0: To compute a vertical visual rhythm" << endl;
+    cout << "   \t\t\t   1: To compute a horizontal visual rhythm" << endl;
+    cout << "   \t\t\t   2: To compute a zig-zag visual rhythm" << endl;
+
+    cout << "  -window_length\t Positive integer that indicates the number of frames of each ";
+    cout << "window. A visual rhythm is saved for each window (default=0, no windows)." << endl;
+
+    cout << "  -window_stride\t Positive integer that indicates the number of frames between the ";
+    cout << "first frames of two windows (default=window_length)." << endl;
+
+    cout << "" << endl;
+
+    cout << "Examples: See README." << endl;
+
+    cout << "" << endl;
+
+    cout << "News, support and information: ";
+    cout << "https://github.com/allansp84/visualrhythm-antispoofing" << endl;
+
+}
+
+bool is_number(string str) {
+    string::const_iterator it = str.begin();
+
+    while (it != str.end() && isdigit(*it)){
+        ++it;
+    }
+
+    return !str.empty() && it == str.end();
+}
+
+bool is_real(string str) {
+    size_t point = str.find('.');
+    size_t start = (!str.empty() && (str[0] == '-' || str[0] == '+')) ? 1 : 0;
+
+    if (point == string::npos) {
+        return is_number(str.substr(start));
+    }
+
+    string integer_part = str.substr(start, point - start);
+    string decimal_part = str.substr(point + 1);
+
+    return (integer_part.empty() || is_number(integer_part)) &&
+      (decimal_part.empty() || is_number(decimal_part)) &&
+      !(integer_part.empty() && decimal_part.empty());
+}
+
+bool parse_shard(const string &shard, int &index, int &number) {
+    size_t slash = shard.find('/');
+
+    if (slash == string::npos || !is_number(shard.substr(0, slash)) ||
+          !is_number(shard.substr(slash + 1))) {
+        return false;
+    }
+
+    index = atoi(shard.substr(0, slash).c_str());
+    number = atoi(shard.substr(slash + 1).c_str());
+
+    return number > 0 && index < number;
+}
+
+bool parse_command_line(int argc, char **argv, Parameters &parameters) {
+
+    int i = 1;
+    bool is_missing_parameter = false;
+
+    // The messages are dropped when the progress is not printed, as in the extraction server
+    ostream messages(parameters.verbose ? cout.rdbuf() : NULL);
+
+    string visual_rhythm_type_pattern = "-visual_rhythm_type";
+    string frame_number_pattern = "-frame_number";
+    string roi_width_pattern = "-roi_width";
+    string filter_pattern = "-filter";
+    string kernel_size_pattern = "-kernel_size";
+    string variance_pattern = "-variance";
+    string color_space_pattern = "-color_space";
+    string input_video_pattern = "-input_video";
+    string output_image_pattern = "-output_image";
+    string server_socket_pattern = "-server_socket";
+    string server_workers_pattern = "-server_workers";
+    string threads_pattern = "-threads";
+    string fast_spectrum_pattern = "-fast_spectrum";
+    string streaming_output_pattern = "-streaming_output";
+    string pipeline_pattern = "-pipeline";
+    string batch_pattern = "-batch";
+    string pin_threads_pattern = "-pin_threads";
+    string score_model_pattern = "-score_model";
+    string score_interval_pattern = "-score_interval";
+    string accept_threshold_pattern = "-accept_threshold";
+    string reject_threshold_pattern = "-reject_threshold";
+    string cpu_level_pattern = "-cpu_level";
+    string journal_pattern = "-journal";
+    string shard_pattern = "-shard";
+    string dataset_pattern = "-dataset";
+    string trace_pattern = "-trace";
+    string window_length_pattern = "-window_length";
+    string window_stride_pattern = "-window_stride";
+    string max_windows_pattern = "-max_windows";
+    string spectrum_batch_pattern = "-spectrum_batch";
+    string row_fusion_pattern = "-row_fusion";
+    string triage_pattern = "-triage";
+    string cache_pattern = "-cache";
+    string row_statistics_pattern = "-row_statistics";
+    string skip_duplicates_pattern = "-skip_duplicates";
+
+    while ((i < argc) && (is_missing_parameter == false)) {
+
+        if (output_image_pattern.compare(0, output_image_pattern.length(), argv[i],
+              output_image_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << output_image_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.output_image = string(argv[i]);
+            }
+
+        } else if (roi_width_pattern.compare(0, roi_width_pattern.length(), argv[i],
+              roi_width_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << roi_width_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.roi_width = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << roi_width_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (kernel_size_pattern.compare(0, kernel_size_pattern.length(), argv[i],
+              kernel_size_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << kernel_size_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.kernel_size = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << kernel_size_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (variance_pattern.compare(0, variance_pattern.length(), argv[i],
+              variance_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << variance_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.variance = atof(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << variance_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (color_space_pattern.compare(0, color_space_pattern.length(), argv[i],
+              color_space_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << color_space_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.color_space = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << color_space_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (visual_rhythm_type_pattern.compare(0, visual_rhythm_type_pattern.length(),
+              argv[i], visual_rhythm_type_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << visual_rhythm_type_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.visual_rhythm_type = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << visual_rhythm_type_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (frame_number_pattern.compare(0, frame_number_pattern.length(), argv[i],
+              frame_number_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << frame_number_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.frame_number = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << frame_number_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (filter_pattern.compare(0, filter_pattern.length(), argv[i],
+              filter_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << filter_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.filter = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << filter_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (input_video_pattern.compare(0, input_video_pattern.length(), argv[i],
+              input_video_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << input_video_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.input_video = string(argv[i]);
+            }
+
+        } else if (server_socket_pattern.compare(0, server_socket_pattern.length(), argv[i],
+              server_socket_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << server_socket_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.server_socket = string(argv[i]);
+            }
+
+        } else if (server_workers_pattern.compare(0, server_workers_pattern.length(), argv[i],
+              server_workers_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << server_workers_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.server_workers = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << server_workers_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (threads_pattern.compare(0, threads_pattern.length(), argv[i],
+              threads_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << threads_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.threads = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << threads_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (fast_spectrum_pattern.compare(0, fast_spectrum_pattern.length(), argv[i],
+              fast_spectrum_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << fast_spectrum_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.fast_spectrum = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << fast_spectrum_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (streaming_output_pattern.compare(0, streaming_output_pattern.length(), argv[i],
+              streaming_output_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << streaming_output_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.streaming_output = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << streaming_output_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (pipeline_pattern.compare(0, pipeline_pattern.length(), argv[i],
+              pipeline_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << pipeline_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.pipeline = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << pipeline_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (batch_pattern.compare(0, batch_pattern.length(), argv[i],
+              batch_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << batch_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.batch = string(argv[i]);
+            }
+
+        } else if (pin_threads_pattern.compare(0, pin_threads_pattern.length(), argv[i],
+              pin_threads_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << pin_threads_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.pin_threads = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << pin_threads_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (score_model_pattern.compare(0, score_model_pattern.length(), argv[i],
+              score_model_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << score_model_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.score_model = string(argv[i]);
+            }
+
+        } else if (score_interval_pattern.compare(0, score_interval_pattern.length(), argv[i],
+              score_interval_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << score_interval_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.score_interval = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << score_interval_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (accept_threshold_pattern.compare(0, accept_threshold_pattern.length(), argv[i],
+              accept_threshold_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << accept_threshold_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_real(argv[i])) {
+                parameters.accept_threshold = atof(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << accept_threshold_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (reject_threshold_pattern.compare(0, reject_threshold_pattern.length(), argv[i],
+              reject_threshold_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << reject_threshold_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_real(argv[i])) {
+                parameters.reject_threshold = atof(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << reject_threshold_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (cpu_level_pattern.compare(0, cpu_level_pattern.length(), argv[i],
+              cpu_level_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << cpu_level_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.cpu_level = string(argv[i]);
+            }
+
+        } else if (journal_pattern.compare(0, journal_pattern.length(), argv[i],
+              journal_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << journal_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.journal = string(argv[i]);
+            }
+
+        } else if (shard_pattern.compare(0, shard_pattern.length(), argv[i],
+              shard_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << shard_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.shard = string(argv[i]);
+            }
+
+        } else if (dataset_pattern.compare(0, dataset_pattern.length(), argv[i],
+              dataset_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << dataset_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.dataset = string(argv[i]);
+            }
+
+        } else if (trace_pattern.compare(0, trace_pattern.length(), argv[i],
+              trace_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << trace_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else {
+                parameters.trace = string(argv[i]);
+            }
+
+        } else if (window_length_pattern.compare(0, window_length_pattern.length(), argv[i],
+              window_length_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << window_length_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.window_length = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << window_length_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (window_stride_pattern.compare(0, window_stride_pattern.length(), argv[i],
+              window_stride_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << window_stride_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.window_stride = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << window_stride_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (max_windows_pattern.compare(0, max_windows_pattern.length(), argv[i],
+              max_windows_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << max_windows_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.max_windows = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << max_windows_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (spectrum_batch_pattern.compare(0, spectrum_batch_pattern.length(), argv[i],
+              spectrum_batch_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << spectrum_batch_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.spectrum_batch = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << spectrum_batch_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (row_fusion_pattern.compare(0, row_fusion_pattern.length(), argv[i],
+              row_fusion_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << row_fusion_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.row_fusion = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << row_fusion_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (triage_pattern.compare(0, triage_pattern.length(), argv[i],
+              triage_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << triage_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.triage = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << triage_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (cache_pattern.compare(0, cache_pattern.length(), argv[i],
+              cache_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << cache_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.cache = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << cache_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (row_statistics_pattern.compare(0, row_statistics_pattern.length(), argv[i],
+              row_statistics_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << row_statistics_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.row_statistics = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << row_statistics_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else if (skip_duplicates_pattern.compare(0, skip_duplicates_pattern.length(), argv[i],
+              skip_duplicates_pattern.length()) == 0) {
+
+            i++;
+            if ((argv[i]) == NULL) {
+                messages << "Missing value for parameter " << skip_duplicates_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            } else if (is_number(argv[i])) {
+                parameters.skip_duplicates = atoi(argv[i]);
+            } else {
+                messages << "Missing value for parameter " << skip_duplicates_pattern;
+                messages << ". See --help." << endl;
+                is_missing_parameter = true;
+            }
+
+        } else {
+
+            messages << "Warning:parse_command_line():unknown parameter " << argv[i];
+            messages << ". See --help." << endl;
+            is_missing_parameter = true;
+
+        }
+
+        i++;
+
+    }
+
+    return is_missing_parameter;
+
+}
+
+bool parse_request_line(const string &line, Parameters &parameters) {
+    vector<string> arguments;
+    vector<char*> argv;
+
+    split_arguments(line, arguments);
+
+    // argv[0] is the program name in the command line
+    argv.push_back(const_cast<char*>(""));
+
+    for (size_t i = 0; i < arguments.size(); i++) {
+        argv.push_back(const_cast<char*>(arguments[i].c_str()));
+    }
+
+    argv.push_back(NULL);
+
+    return parse_command_line(static_cast<int>(argv.size()) - 1, &argv[0], parameters);
+}
+
+void split_arguments(const string &line, vector<string> &arguments) {
+    string argument = "";
+    bool is_quoted = false;
+    bool has_argument = false;
+
+    arguments.clear();
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+
+        if (c == '"') {
+            is_quoted = !is_quoted;
+            has_argument = true;
+        } else if (!is_quoted && isspace(static_cast<unsigned char>(c))) {
+            if (has_argument) {
+                arguments.push_back(argument);
+                argument.clear();
+                has_argument = false;
+            }
+        } else {
+            argument += c;
+            has_argument = true;
+        }
+    }
+
+    if (has_argument) {
+        arguments.push_back(argument);
+    }
+}
+
+void split_filename(string str, string &path, string &file, string &extension) {
+
+    size_t found = str.find_last_of("/\\");
+    size_t last_dot = str.find_last_of(".");
+
+    if (found != string::npos) {
+        path = str.substr(0,found);
+        file = str.substr(found+1);
+
+    } else {
+        file = str;
+    }
+
+    if (last_dot != string::npos) {
+        extension = str.substr(last_dot+1);
+    }
+
+}
+
+bool verify_command_line(Parameters &parameters){
+
+    bool is_missing_parameter = false;
+    struct stat file_stat;
+
+    string path = "";
+    string file = "";
+    string extension = "";
+
+    // The messages are dropped when the progress is not printed, as in the extraction server
+    ostream messages(parameters.verbose ? cout.rdbuf() : NULL);
+
+    if ((parameters.visual_rhythm_type < 0) || (parameters.visual_rhythm_type > 2)) {
+        messages << "Invalid value used in visual_rhythm_type. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.frame_number < 1) {
+        messages << "Invalid value used in frame_number. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.roi_width < 1) {
+        messages << "Invalid value used in roi_width. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.filter < 0) || (parameters.filter > 2)) {
+        messages << "Invalid value used in filter. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.fast_spectrum < 0) || (parameters.fast_spectrum > 1)) {
+        messages << "Invalid value used in fast_spectrum. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.kernel_size < 3) || (parameters.kernel_size % 2 == 0)) {
+        messages << "Invalid value used in kernel_size. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (get_kernel_level_by_name(parameters.cpu_level) < 0) {
+        messages << "Invalid value used in cpu_level. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.score_interval < 1) {
+        messages << "Invalid value used in score_interval. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.reject_threshold > parameters.accept_threshold) {
+        messages << "Invalid value used in reject_threshold. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (!parameters.score_model.empty() && parameters.streaming_output == 1) {
+        messages << "The score_model parameter can not be used with streaming_output. See --help";
+        messages << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.pin_threads < 0) || (parameters.pin_threads > 1)) {
+        messages << "Invalid value used in pin_threads. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    int shard_index = 0, shard_number = 1;
+
+    if (!parameters.shard.empty() && !parse_shard(parameters.shard, shard_index, shard_number)) {
+        messages << "Invalid value used in shard. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.skip_duplicates < 0) || (parameters.skip_duplicates > 1)) {
+        messages << "Invalid value used in skip_duplicates. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    // The stages of the pipeline run on their own threads, one frame behind each other
+    if (parameters.skip_duplicates == 1 && parameters.pipeline == 1) {
+        messages << "The skip_duplicates parameter can not be used with pipeline. See --help";
+        messages << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.row_statistics < 0) || (parameters.row_statistics > 1)) {
+        messages << "Invalid value used in row_statistics. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.row_statistics == 1 && (parameters.streaming_output == 1 ||
+          parameters.window_length > 0 || !parameters.score_model.empty())) {
+        messages << "The row_statistics parameter can not be used with streaming_output, ";
+        messages << "window_length or score_model. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.cache < 0) || (parameters.cache > 1)) {
+        messages << "Invalid value used in cache. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    // The windows are saved in their own files, not in output_image
+    if (parameters.window_length > 0 && (parameters.cache == 1 || !parameters.journal.empty() ||
+          !parameters.dataset.empty())) {
+        messages << "The window_length parameter can not be used with cache, journal or dataset. ";
+        messages << "See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.triage < 0) || (parameters.triage > 1)) {
+        messages << "Invalid value used in triage. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.triage == 1 && (parameters.window_length > 0 ||
+          !parameters.score_model.empty())) {
+        messages << "The triage parameter can not be used with window_length or score_model. ";
+        messages << "See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.window_length < 0) || (parameters.window_stride < 0) ||
+          (parameters.max_windows < 0)) {
+        messages << "Invalid value used in window_length, window_stride or max_windows. See --help";
+        messages << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.window_length > 0 && (parameters.streaming_output == 1 ||
+          !parameters.score_model.empty())) {
+        messages << "The window_length parameter can not be used with streaming_output or ";
+        messages << "score_model. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.row_fusion < 0) || (parameters.row_fusion > 1)) {
+        messages << "Invalid value used in row_fusion. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.row_fusion == 1 && (parameters.filter == 2 || parameters.pipeline == 1 ||
+          parameters.spectrum_batch > 1)) {
+        messages << "The row_fusion parameter can not be used with filter 2, pipeline or ";
+        messages << "spectrum_batch. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.spectrum_batch < 1) || (parameters.spectrum_batch > 64)) {
+        messages << "Invalid value used in spectrum_batch. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.spectrum_batch > 1 && parameters.pipeline == 1) {
+        messages << "The spectrum_batch parameter can not be used with pipeline. See --help";
+        messages << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.pipeline < 0) || (parameters.pipeline > 1)) {
+        messages << "Invalid value used in pipeline. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.streaming_output < 0) || (parameters.streaming_output > 1)) {
+        messages << "Invalid value used in streaming_output. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.threads < 1) {
+        messages << "Invalid value used in threads. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (parameters.variance < 0) {
+        messages << "Invalid value used in variance. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if ((parameters.color_space < 0) || (parameters.color_space > 1)) {
+        messages << "Invalid value used in color_space. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    if (lstat(parameters.input_video.c_str(), &file_stat) == -1) {
+        if (parameters.verbose) {
+            fprintf(stderr, "%s\n", strerror(errno));
+        }
+        messages << "Invalid value used in input_video. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    split_filename(parameters.output_image, path, file, extension);
+
+    if (file.empty()) {
+        messages << "Invalid file name used in output_image. See --help" << endl;
+        is_missing_parameter = true;
+    }
+
+    // The streamed visual rhythm is saved as a PGM image and the row statistics as text
+    string required_extension = (parameters.streaming_output == 1) ? "pgm" : "png";
+
+    if (parameters.row_statistics == 1) {
+        required_extension = "txt";
+    }
+
+    if (extension.empty() || extension.compare(required_extension)) {
+        parameters.output_image += "." + required_extension;
+    }
+
+    // The visual rhythm of the keyframes is not mistaken for that of consecutive frames
+    if (parameters.triage == 1) {
+        parameters.output_image.insert(parameters.output_image.find_last_of("."), "_triage");
+    }
+
+    if (!path.empty()) {
+        create_path(path, 0755);
+    }
+
+    return is_missing_parameter;
+
+}
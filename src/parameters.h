@@ -0,0 +1,190 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef PARAMETERS_H_
+#define PARAMETERS_H_
+
+// It contains functions to control input and output stream
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+using namespace std;
+
+// Parameters used to compute a visual rhythm, filled from the command line or from a request
+// received by the extraction server
+struct Parameters {
+
+    // Color space of the frames before to extract the noise
+    int color_space;
+
+    // Filter used to compute the residual noise video
+    int filter;
+
+    // Number of consecutive frames used during computation of the visual rhythm
+    int frame_number;
+
+    // Filename of the input video
+    string input_video;
+
+    // Kernel size used during filtering of the input video
+    int kernel_size;
+
+    // Filename of the computed visual rhythm
+    string output_image;
+
+    // Width of the region of interest extracted of each frame
+    int roi_width;
+
+    // Variance of the gaussian filter
+    float variance;
+
+    // Type of visual rhythm to be computed
+    int visual_rhythm_type;
+
+    // Unix socket path where the extraction server listens (empty means no server)
+    string server_socket;
+
+    // Number of workers of the extraction server
+    int server_workers;
+
+    // Number of threads used to compute each frame
+    int threads;
+
+    // To approximate the post-processing of the fourier spectrum
+    int fast_spectrum;
+
+    // To stream the strips to the output file instead of keeping the visual rhythm in memory
+    int streaming_output;
+
+    // To run each stage of the frame processing on its own thread
+    int pipeline;
+
+    // Manifest with the videos of a batch, one line per video with its options
+    string batch;
+
+    // To pin the threads of each video of a batch to its cores
+    int pin_threads;
+
+    // Linear model scoring the partial visual rhythm for an early decision
+    string score_model;
+
+    // Number of frames between two evaluations of the score
+    int score_interval;
+
+    // Score above which the access is accepted as genuine
+    float accept_threshold;
+
+    // Score below which the access is rejected as an attack
+    float reject_threshold;
+
+    // Instruction set level of the kernels (auto, generic, sse42, avx2 or avx512)
+    string cpu_level;
+
+    // Journal of the completed videos of a batch, to resume it after an interruption
+    string journal;
+
+    // Shard of a batch computed by this process, as index/number (empty means the whole batch)
+    string shard;
+
+    // Dataset container written with the visual rhythms of a batch (empty means no container)
+    string dataset;
+
+    // Trace file written at the exit of the program (empty means no trace)
+    string trace;
+
+    // Number of frames of each window (0 means one visual rhythm of the first frame_number frames)
+    int window_length;
+
+    // Number of frames between the first frames of two consecutive windows (0 means window_length)
+    int window_stride;
+
+    // Largest number of windows (0 means all windows of the video)
+    int max_windows;
+
+    // Number of frames whose Fourier spectra are computed together
+    int spectrum_batch;
+
+    // To compute the noise image and the row pass of the transform together in blocks of rows
+    int row_fusion;
+
+    // To read only the keyframes of the video
+    int triage;
+
+    // To skip the extraction when the input video and the parameters did not change
+    int cache;
+
+    // To keep only the statistics of each row of the visual rhythm over time
+    int row_statistics;
+
+    // To reuse the strip of the previous frame for identical decoded frames
+    int skip_duplicates;
+
+    // To print the progress messages
+    bool verbose;
+
+    // Constructor
+    Parameters();
+
+};
+
+// To create all directories of a path
+int create_path(string str, mode_t mode);
+
+// To show the usage of the program
+void help(string filename);
+
+// Is the string a non-negative integer?
+bool is_number(string str);
+
+// Is the string a real number, with optional sign and decimal part?
+bool is_real(string str);
+
+// To parse a shard given as index/number, returns false if it is invalid
+bool parse_shard(const string &shard, int &index, int &number);
+
+// To parse the command line, returns true when some parameter is missing or invalid
+bool parse_command_line(int argc, char **argv, Parameters &parameters);
+
+// To parse a request line containing the same options of the command line
+bool parse_request_line(const string &line, Parameters &parameters);
+
+// To split a line into arguments separated by blank spaces (double quotes group an argument)
+void split_arguments(const string &line, vector<string> &arguments);
+
+// To split a filename into path, file and extension
+void split_filename(string str, string &path, string &file, string &extension);
+
+// To verify the parameters, returns true when some parameter is missing or invalid
+bool verify_command_line(Parameters &parameters);
+
+#endif /* PARAMETERS_H_ */
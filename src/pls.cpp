@@ -0,0 +1,365 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "pls.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Smallest squared norm of X^T y, relative to the first factor, below which the remaining
+// covariance is rounding noise of the deflations in single precision and the fit stops
+#define PLS_EPSILON 1e-10
+
+PLSRegression::PLSRegression() {
+    this->factor_number = 10;
+    this->fitted_factor_number = 0;
+    this->thread_pool = NULL;
+    this->response_mean = 0.0;
+}
+
+void PLSRegression::set_factor_number(int factor_number) {
+    this->factor_number = factor_number;
+}
+
+int PLSRegression::get_fitted_factor_number() const {
+    return this->fitted_factor_number;
+}
+
+void PLSRegression::set_thread_pool(ThreadPool *thread_pool) {
+    this->thread_pool = thread_pool;
+}
+
+int PLSRegression::get_band_number(int rows) const {
+    if (this->thread_pool == NULL) {
+        return 1;
+    }
+
+    return std::max(1, std::min(this->thread_pool->get_thread_number(), rows));
+}
+
+int PLSRegression::run_bands(int rows,
+  const std::function<void(int band, int begin, int end)> &body) {
+
+    int band_number = get_band_number(rows);
+
+    if (band_number == 1) {
+        body(0, 0, rows);
+        return 1;
+    }
+
+    this->thread_pool->parallel_for(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(rows, band_number, band, begin, end);
+        body(band, begin, end);
+    });
+
+    return band_number;
+}
+
+void PLSRegression::reduce(const vector< vector<double> > &partials, int bands,
+  vector<double> &output) const {
+
+    output.assign(partials[0].begin(), partials[0].end());
+
+    for (int b = 1; b < bands; b++) {
+        const double *partial = &partials[b][0];
+
+        for (size_t j = 0; j < output.size(); j++) {
+            output[j] += partial[j];
+        }
+    }
+}
+
+void PLSRegression::project(const Mat &features, const vector<double> &weights,
+  vector<double> &scores) {
+
+    const int cols = features.cols;
+    const double *w = &weights[0];
+
+    scores.resize(features.rows);
+
+    run_bands(features.rows, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const float *x = features.ptr<float>(i);
+            double sum = 0.0;
+
+            for (int j = 0; j < cols; j++) {
+                sum += x[j] * w[j];
+            }
+
+            scores[i] = sum;
+        }
+    });
+}
+
+void PLSRegression::project_transposed(const Mat &features, const vector<double> &scores,
+  vector<double> &output) {
+
+    const int cols = features.cols;
+    vector< vector<double> > partials(get_band_number(features.rows));
+
+    int bands = run_bands(features.rows, [&](int band, int begin, int end) {
+        vector<double> &partial = partials[band];
+        partial.assign(cols, 0.0);
+        double *v = &partial[0];
+
+        for (int i = begin; i < end; i++) {
+            const float *x = features.ptr<float>(i);
+            const double t = scores[i];
+
+            for (int j = 0; j < cols; j++) {
+                v[j] += t * x[j];
+            }
+        }
+    });
+
+    reduce(partials, bands, output);
+}
+
+void PLSRegression::deflate(Mat &features, const vector<double> &scores,
+  const vector<double> &loadings, const vector<double> &response, vector<double> &output) {
+
+    const int cols = features.cols;
+    const double *p = &loadings[0];
+    vector< vector<double> > partials(get_band_number(features.rows));
+
+    int bands = run_bands(features.rows, [&](int band, int begin, int end) {
+        vector<double> &partial = partials[band];
+        partial.assign(cols, 0.0);
+        double *v = &partial[0];
+
+        for (int i = begin; i < end; i++) {
+            float *x = features.ptr<float>(i);
+            const double t = scores[i];
+            const double y = response[i];
+
+            for (int j = 0; j < cols; j++) {
+                float deflated = static_cast<float>(x[j] - t * p[j]);
+
+                x[j] = deflated;
+                v[j] += y * deflated;
+            }
+        }
+    });
+
+    reduce(partials, bands, output);
+}
+
+bool PLSRegression::fit(const Mat &features, const vector<float> &responses) {
+    const int rows = features.rows;
+    const int cols = features.cols;
+
+    this->fitted_factor_number = 0;
+
+    if (features.type() != CV_32F || rows < 2 || cols < 1 ||
+          responses.size() != static_cast<size_t>(rows) || this->factor_number < 1) {
+        cout << "Error:PLSRegression::fit():Invalid features or responses" << endl;
+        return false;
+    }
+
+    // Standardized copy of the features, deflated by each factor
+    vector<double> ones(rows, 1.0), sums, squares;
+    Mat x;
+
+    project_transposed(features, ones, sums);
+    this->means.resize(cols);
+    this->deviations.resize(cols);
+
+    for (int j = 0; j < cols; j++) {
+        this->means[j] = sums[j] / rows;
+    }
+
+    features.copyTo(x);
+    run_bands(rows, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            float *row = x.ptr<float>(i);
+
+            for (int j = 0; j < cols; j++) {
+                row[j] = static_cast<float>(row[j] - this->means[j]);
+            }
+        }
+    });
+
+    // The deviations come from the squares of the centered features
+    Mat squared;
+    multiply(x, x, squared);
+    project_transposed(squared, ones, squares);
+
+    for (int j = 0; j < cols; j++) {
+        double deviation = std::sqrt(squares[j] / (rows - 1));
+        this->deviations[j] = (deviation > 1e-12) ? deviation : 1.0;
+    }
+
+    run_bands(rows, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            float *row = x.ptr<float>(i);
+
+            for (int j = 0; j < cols; j++) {
+                row[j] = static_cast<float>(row[j] / this->deviations[j]);
+            }
+        }
+    });
+
+    // Centered response
+    vector<double> y(responses.begin(), responses.end());
+    this->response_mean = 0.0;
+
+    for (int i = 0; i < rows; i++) {
+        this->response_mean += y[i];
+    }
+
+    this->response_mean /= rows;
+
+    for (int i = 0; i < rows; i++) {
+        y[i] -= this->response_mean;
+    }
+
+    // NIPALS for one response: each factor takes the direction of X^T y
+    int factors = std::min(this->factor_number, std::min(rows - 1, cols));
+    vector< vector<double> > weights, loadings;
+    vector<double> q, v, t, p;
+
+    double first_norm = 0.0;
+
+    project_transposed(x, y, v);
+
+    for (int k = 0; k < factors; k++) {
+        double norm = 0.0;
+
+        for (int j = 0; j < cols; j++) {
+            norm += v[j] * v[j];
+        }
+
+        if (k == 0) {
+            first_norm = norm;
+        }
+
+        if (norm <= PLS_EPSILON * first_norm || norm == 0.0) {
+            break;
+        }
+
+        norm = std::sqrt(norm);
+
+        for (int j = 0; j < cols; j++) {
+            v[j] /= norm;
+        }
+
+        project(x, v, t);
+
+        double tt = 0.0, yt = 0.0;
+
+        for (int i = 0; i < rows; i++) {
+            tt += t[i] * t[i];
+            yt += y[i] * t[i];
+        }
+
+        if (tt <= 0.0) {
+            break;
+        }
+
+        project_transposed(x, t, p);
+
+        for (int j = 0; j < cols; j++) {
+            p[j] /= tt;
+        }
+
+        q.push_back(yt / tt);
+
+        for (int i = 0; i < rows; i++) {
+            y[i] -= q.back() * t[i];
+        }
+
+        weights.push_back(v);
+        loadings.push_back(p);
+
+        if (k + 1 < factors) {
+            deflate(x, t, p, y, v);
+        }
+    }
+
+    int k = static_cast<int>(q.size());
+
+    if (k == 0) {
+        cout << "Error:PLSRegression::fit():The features do not explain the responses" << endl;
+        return false;
+    }
+
+    // Coefficients B = W (P^T W)^-1 q
+    Mat pw(k, k, CV_64F), q_mat(k, 1, CV_64F), c;
+
+    for (int a = 0; a < k; a++) {
+        q_mat.at<double>(a, 0) = q[a];
+
+        for (int b = 0; b < k; b++) {
+            double sum = 0.0;
+
+            for (int j = 0; j < cols; j++) {
+                sum += loadings[a][j] * weights[b][j];
+            }
+
+            pw.at<double>(a, b) = sum;
+        }
+    }
+
+    if (!solve(pw, q_mat, c, DECOMP_LU)) {
+        cout << "Error:PLSRegression::fit():Singular loadings" << endl;
+        return false;
+    }
+
+    this->coefficients.assign(cols, 0.0);
+
+    for (int a = 0; a < k; a++) {
+        double factor = c.at<double>(a, 0);
+
+        for (int j = 0; j < cols; j++) {
+            this->coefficients[j] += weights[a][j] * factor;
+        }
+    }
+
+    this->fitted_factor_number = k;
+
+    return true;
+}
+
+void PLSRegression::get_linear_model(vector<float> &weights, float &bias) const {
+    double sum = this->response_mean;
+
+    weights.resize(this->coefficients.size());
+
+    for (size_t j = 0; j < this->coefficients.size(); j++) {
+        double weight = this->coefficients[j] / this->deviations[j];
+
+        weights[j] = static_cast<float>(weight);
+        sum -= weight * this->means[j];
+    }
+
+    bias = static_cast<float>(sum);
+}
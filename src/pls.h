@@ -0,0 +1,116 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef PLS_H_
+#define PLS_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+#include "threadpool.h"
+
+#include <functional>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+// Class liable for a partial least squares regression of one response (PLS1), fitted by the
+// NIPALS algorithm on standardized features. Each factor needs three passes over the features:
+// the scores (X w), the loadings (X^T t) and the deflation of X fused with the weights of the
+// next factor (X^T y). The passes split the samples in bands of rows run by the thread pool; the
+// transposed products accumulate one partial vector per band, added at the end. The fitted model
+// is linear on the raw features, as the LinearScorer (see scorer.h).
+class PLSRegression {
+
+private:
+
+    // Number of factors to be extracted
+    int factor_number;
+
+    // Number of factors extracted by the last fit (less than factor_number when X is exhausted)
+    int fitted_factor_number;
+
+    // Pool of threads used to split the samples in bands of rows (NULL means sequential)
+    ThreadPool *thread_pool;
+
+    // Means of the features and of the response
+    vector<double> means;
+    double response_mean;
+
+    // Standard deviations of the features (1 for constant features)
+    vector<double> deviations;
+
+    // Regression coefficients on the standardized features
+    vector<double> coefficients;
+
+    // To get the number of bands of rows used by the kernels
+    int get_band_number(int rows) const;
+
+    // To run body(begin, end) on bands of the rows [0, rows), returns the number of bands
+    int run_bands(int rows, const std::function<void(int band, int begin, int end)> &body);
+
+    // To compute the scores t = X w
+    void project(const Mat &features, const vector<double> &weights, vector<double> &scores);
+
+    // To compute v = X^T t
+    void project_transposed(const Mat &features, const vector<double> &scores,
+      vector<double> &output);
+
+    // To deflate X -= t p^T and compute v = X^T y on the deflated X in the same pass
+    void deflate(Mat &features, const vector<double> &scores, const vector<double> &loadings,
+      const vector<double> &response, vector<double> &output);
+
+    // To add the partial vectors of the bands into output
+    void reduce(const vector< vector<double> > &partials, int bands, vector<double> &output) const;
+
+public:
+
+    // Constructor
+    PLSRegression();
+
+    // To set the number of factors
+    void set_factor_number(int factor_number);
+
+    // To get the number of factors extracted by the last fit
+    int get_fitted_factor_number() const;
+
+    // To set the pool of threads used by the matrix kernels (NULL means sequential)
+    void set_thread_pool(ThreadPool *thread_pool);
+
+    // To fit the model on the features (one sample per row, CV_32F) and their responses
+    bool fit(const Mat &features, const vector<float> &responses);
+
+    // To get the model as weights and bias on the raw features
+    void get_linear_model(vector<float> &weights, float &bias) const;
+
+};
+
+#endif /* PLS_H_ */
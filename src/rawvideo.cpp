@@ -0,0 +1,373 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "rawvideo.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+RawVideo::RawVideo() {
+    this->data = NULL;
+    this->size = 0;
+    this->width = 0;
+    this->height = 0;
+    this->frame_rate = 25.0;
+    this->next_frame = 0;
+    this->page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+RawVideo::~RawVideo() {
+    release();
+}
+
+bool RawVideo::is_raw_video(const string &filename) {
+    size_t point = filename.rfind('.');
+
+    if (point == string::npos) {
+        return false;
+    }
+
+    string extension = filename.substr(point + 1);
+
+    return extension.compare("y4m") == 0 || extension.compare("yuv") == 0;
+}
+
+bool RawVideo::open(const string &filename) {
+    struct stat status;
+
+    release();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    if (fstat(fd, &status) < 0 || status.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    this->size = static_cast<size_t>(status.st_size);
+
+    void *mapping = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+        this->size = 0;
+        return false;
+    }
+
+    this->data = static_cast<uchar*>(mapping);
+
+    // The frames are read in order, so the pages already read may be dropped early
+    madvise(this->data, this->size, MADV_SEQUENTIAL);
+
+    bool is_y4m = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".y4m") == 0;
+    bool is_indexed = is_y4m ? open_y4m() : open_yuv(filename);
+
+    if (!is_indexed || this->frame_offsets.empty()) {
+        cout << "Error:RawVideo::open():Unsupported raw video " << filename << endl;
+        release();
+        return false;
+    }
+
+    this->next_frame = 0;
+    read_ahead(0);
+
+    return true;
+}
+
+bool RawVideo::open_frames(const vector<Mat> &frames, double frame_rate) {
+
+    release();
+
+    if (frames.empty()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (frames[i].size() != frames[0].size() || frames[i].type() != frames[0].type() ||
+              (frames[i].type() != CV_8UC1 && frames[i].type() != CV_8UC3)) {
+            cout << "Error:RawVideo::open_frames():Frames with different sizes or types" << endl;
+            return false;
+        }
+    }
+
+    this->memory_frames = frames;
+    this->width = frames[0].cols;
+    this->height = frames[0].rows;
+    this->frame_rate = (frame_rate > 0.0) ? frame_rate : 25.0;
+    this->next_frame = 0;
+
+    return true;
+}
+
+bool RawVideo::open_y4m() {
+    const char *signature = "YUV4MPEG2 ";
+    const char *marker = "FRAME";
+    size_t offset = 0;
+    size_t chroma_size = 0;
+    string colorspace = "420jpeg";
+
+    const uchar *end_header = static_cast<const uchar*>(memchr(this->data, '\n', this->size));
+
+    if (end_header == NULL || this->size < strlen(signature) ||
+          memcmp(this->data, signature, strlen(signature)) != 0) {
+        return false;
+    }
+
+    istringstream header(string(reinterpret_cast<const char*>(this->data), end_header - this->data));
+    string field = "";
+
+    // Each field is a tag letter followed by its value
+    while (header >> field) {
+        switch (field[0]) {
+            case 'W':
+                this->width = atoi(field.c_str() + 1);
+                break;
+            case 'H':
+                this->height = atoi(field.c_str() + 1);
+                break;
+            case 'F': {
+                int numerator = 0;
+                int denominator = 1;
+                if (sscanf(field.c_str() + 1, "%d:%d", &numerator, &denominator) == 2 &&
+                      numerator > 0 && denominator > 0) {
+                    this->frame_rate = static_cast<double>(numerator) / denominator;
+                }
+                break;
+            }
+            case 'C':
+                colorspace = field.substr(1);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (this->width <= 0 || this->height <= 0 || !get_chroma_size(colorspace, chroma_size)) {
+        return false;
+    }
+
+    size_t frame_size = static_cast<size_t>(this->width) * this->height + chroma_size;
+
+    offset = (end_header - this->data) + 1;
+
+    // Each frame starts with a FRAME line, which may have parameters
+    while (offset + strlen(marker) <= this->size &&
+          memcmp(this->data + offset, marker, strlen(marker)) == 0) {
+
+        const uchar *end_frame_header = static_cast<const uchar*>(memchr(this->data + offset, '\n',
+          this->size - offset));
+
+        if (end_frame_header == NULL) {
+            break;
+        }
+
+        offset = (end_frame_header - this->data) + 1;
+
+        if (offset + frame_size > this->size) {
+            break;
+        }
+
+        this->frame_offsets.push_back(offset);
+        offset += frame_size;
+    }
+
+    return true;
+}
+
+bool RawVideo::open_yuv(const string &filename) {
+    size_t slash = filename.rfind('/');
+    string name = (slash == string::npos) ? filename : filename.substr(slash + 1);
+
+    // The last <width>x<height> of the filename gives the frame size
+    for (size_t x = name.rfind('x'); x != string::npos && x > 0; x = name.rfind('x', x - 1)) {
+        size_t begin = x;
+        size_t end = x + 1;
+
+        while (begin > 0 && isdigit(name[begin - 1])) {
+            begin--;
+        }
+
+        while (end < name.size() && isdigit(name[end])) {
+            end++;
+        }
+
+        if (begin < x && end > x + 1) {
+            this->width = atoi(name.substr(begin, x - begin).c_str());
+            this->height = atoi(name.substr(x + 1, end - x - 1).c_str());
+            break;
+        }
+    }
+
+    if (this->width <= 0 || this->height <= 0 || this->width % 2 != 0 || this->height % 2 != 0) {
+        return false;
+    }
+
+    size_t frame_size = static_cast<size_t>(this->width) * this->height * 3 / 2;
+
+    for (size_t offset = 0; offset + frame_size <= this->size; offset += frame_size) {
+        this->frame_offsets.push_back(offset);
+    }
+
+    return true;
+}
+
+bool RawVideo::get_chroma_size(const string &colorspace, size_t &chroma_size) const {
+    size_t chroma_width = (this->width + 1) / 2;
+    size_t chroma_height = (this->height + 1) / 2;
+
+    if (colorspace.compare("mono") == 0) {
+        chroma_size = 0;
+    } else if (colorspace.compare("420") == 0 || colorspace.compare("420jpeg") == 0 ||
+          colorspace.compare("420paldv") == 0 || colorspace.compare("420mpeg2") == 0) {
+        chroma_size = 2 * chroma_width * chroma_height;
+    } else if (colorspace.compare("422") == 0) {
+        chroma_size = 2 * chroma_width * this->height;
+    } else if (colorspace.compare("444") == 0) {
+        chroma_size = 2 * static_cast<size_t>(this->width) * this->height;
+    } else {
+        // Formats with more than 8 bits per sample (420p10, ...) or alpha are not supported
+        return false;
+    }
+
+    return true;
+}
+
+void RawVideo::release() {
+
+    if (this->data != NULL) {
+        munmap(this->data, this->size);
+    }
+
+    this->data = NULL;
+    this->size = 0;
+    this->width = 0;
+    this->height = 0;
+    this->frame_rate = 25.0;
+    this->next_frame = 0;
+    this->frame_offsets.clear();
+    this->memory_frames.clear();
+}
+
+bool RawVideo::is_opened() const {
+    return this->data != NULL || !this->memory_frames.empty();
+}
+
+bool RawVideo::read(Mat &frame) {
+
+    if (!is_opened() || this->next_frame >= get_total_frame_count()) {
+        return false;
+    }
+
+    if (!this->memory_frames.empty()) {
+        frame = this->memory_frames[this->next_frame++];
+        return true;
+    }
+
+    frame = Mat(this->height, this->width, CV_8U, this->data + this->frame_offsets[this->next_frame]);
+
+    this->next_frame++;
+
+    if (this->next_frame % RAW_READ_AHEAD_FRAMES == 0) {
+        read_ahead(this->next_frame);
+    }
+
+    return true;
+}
+
+void RawVideo::read_ahead(long frame) {
+
+    if (this->data == NULL) {
+        return;
+    }
+
+    long last = std::min(frame + RAW_READ_AHEAD_FRAMES, get_total_frame_count()) - 1;
+
+    if (frame > last) {
+        return;
+    }
+
+    size_t begin = this->frame_offsets[frame] & ~(this->page_size - 1);
+    size_t end = this->frame_offsets[last] + static_cast<size_t>(this->width) * this->height;
+
+    madvise(this->data + begin, std::min(end, this->size) - begin, MADV_WILLNEED);
+}
+
+bool RawVideo::set_position_frame_number(long frame_number) {
+
+    if (frame_number < 0 || frame_number > get_total_frame_count()) {
+        return false;
+    }
+
+    this->next_frame = frame_number;
+    read_ahead(frame_number);
+
+    return true;
+}
+
+long RawVideo::get_position_frame_number() const {
+    return this->next_frame;
+}
+
+long RawVideo::get_total_frame_count() const {
+
+    if (!this->memory_frames.empty()) {
+        return static_cast<long>(this->memory_frames.size());
+    }
+
+    return static_cast<long>(this->frame_offsets.size());
+}
+
+int RawVideo::get_frame_width() const {
+    return this->width;
+}
+
+int RawVideo::get_frame_height() const {
+    return this->height;
+}
+
+double RawVideo::get_frame_rate() const {
+    return this->frame_rate;
+}
@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef RAWVIDEO_H_
+#define RAWVIDEO_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+// Number of frames whose pages are requested ahead of the frame being read
+#define RAW_READ_AHEAD_FRAMES 8
+
+// Class liable for reading pre-decoded videos without codecs. The file is mapped in memory and
+// each frame is returned as a view of its luma plane, without copies nor color conversions.
+// Supported formats are YUV4MPEG2 (.y4m, 8 bits, 4:2:0, 4:2:2, 4:4:4 or mono) and planar YUV 4:2:0
+// (.yuv), whose frame size is taken from the filename (for example video_1280x720.yuv). Frames
+// already in memory (gray or BGR) may be read in the same way.
+class RawVideo {
+
+private:
+
+    // Mapped file (NULL if no file is opened)
+    uchar *data;
+
+    // Size of the mapped file
+    size_t size;
+
+    // Width of the frames
+    int width;
+
+    // Height of the frames
+    int height;
+
+    // Frames per second
+    double frame_rate;
+
+    // Offset of the luma plane of each frame in the file
+    vector<size_t> frame_offsets;
+
+    // Frames given in memory instead of a mapped file
+    vector<Mat> memory_frames;
+
+    // Index of the next frame to be read
+    long next_frame;
+
+    // Size of the system pages, used to align the read-ahead requests
+    size_t page_size;
+
+    // To read the header of a YUV4MPEG2 file and index its frames
+    bool open_y4m();
+
+    // To take the frame size from the filename of a planar YUV file and index its frames
+    bool open_yuv(const string &filename);
+
+    // To get the size of the chroma planes of a frame from a YUV4MPEG2 colorspace tag
+    bool get_chroma_size(const string &colorspace, size_t &chroma_size) const;
+
+    // To request the pages of the next frames to the system
+    void read_ahead(long frame);
+
+public:
+
+    // Constructor
+    RawVideo();
+
+    // Destructor
+    ~RawVideo();
+
+    // Is the filename of a pre-decoded video (.y4m or .yuv)?
+    static bool is_raw_video(const string &filename);
+
+    // To open a pre-decoded video
+    bool open(const string &filename);
+
+    // To read frames already in memory, all with the same size and type (CV_8UC1 or CV_8UC3).
+    // The frames are not copied, so they must stay valid until the video is released.
+    bool open_frames(const vector<Mat> &frames, double frame_rate);
+
+    // To close the video
+    void release();
+
+    // Is a video opened?
+    bool is_opened() const;
+
+    // To get the luma plane of the next frame, the view is valid until the video is released
+    bool read(Mat &frame);
+
+    // To go to this frame number
+    bool set_position_frame_number(long frame_number);
+
+    // To get the index of the next frame
+    long get_position_frame_number() const;
+
+    // To get the number of frames
+    long get_total_frame_count() const;
+
+    // To get the width of the frames
+    int get_frame_width() const;
+
+    // To get the height of the frames
+    int get_frame_height() const;
+
+    // To get the frame rate
+    double get_frame_rate() const;
+
+};
+
+#endif /* RAWVIDEO_H_ */
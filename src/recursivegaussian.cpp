@@ -0,0 +1,207 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "recursivegaussian.h"
+
+#include <algorithm>
+#include <cmath>
+
+RecursiveGaussian::RecursiveGaussian() {
+    set_sigma(2.0f);
+}
+
+void RecursiveGaussian::set_sigma(float sigma) {
+    double q = 0.0;
+
+    this->sigma = std::max(sigma, 0.5f);
+
+    // Coefficients of Young and van Vliet, "Recursive implementation of the Gaussian filter",
+    // Signal Processing 44 (1995)
+    if (this->sigma >= 2.5f) {
+        q = 0.98711 * this->sigma - 0.96330;
+    } else {
+        q = 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * this->sigma);
+    }
+
+    double q2 = q * q;
+    double q3 = q2 * q;
+
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    double b3 = 0.422205 * q3;
+
+    this->feedback[0] = static_cast<float>(b1 / b0);
+    this->feedback[1] = static_cast<float>(b2 / b0);
+    this->feedback[2] = static_cast<float>(b3 / b0);
+    this->gain = static_cast<float>(1.0 - (b1 + b2 + b3) / b0);
+}
+
+void RecursiveGaussian::compute_residual(const Mat &image, Mat &output) {
+    prepare(image);
+    output.create(image.size(), CV_8U);
+    filter_rows(image, 0, image.rows);
+    filter_columns_residual(image, output, 0, image.cols);
+}
+
+void RecursiveGaussian::prepare(const Mat &image) {
+    this->buffer.create(image.size(), CV_32F);
+}
+
+void RecursiveGaussian::filter_rows(const Mat &image, int begin, int end) {
+    const int block = RECURSIVE_GAUSSIAN_BLOCK;
+    const int cols = image.cols;
+    const float gain = this->gain;
+    const float a1 = this->feedback[0];
+    const float a2 = this->feedback[1];
+    const float a3 = this->feedback[2];
+
+    // The pixels of a block of rows are interleaved (x-major), so each step of the recursion
+    // along x updates the block rows with contiguous loads and stores
+    vector<float> samples((cols + 6) * block);
+
+    for (int y0 = begin; y0 < end; y0 += block) {
+        int rows = std::min(block, end - y0);
+
+        // Three border samples on each side hold the initial states of the recursion
+        float *s = &samples[3 * block];
+
+        for (int r = 0; r < block; r++) {
+            const uchar *row = image.ptr<uchar>(y0 + std::min(r, rows - 1));
+            for (int x = 0; x < cols; x++) {
+                s[x * block + r] = row[x];
+            }
+        }
+
+        // Causal pass, starting from the steady state of the first pixel
+        for (int r = 0; r < block; r++) {
+            s[-block + r] = s[r];
+            s[-2 * block + r] = s[r];
+            s[-3 * block + r] = s[r];
+        }
+
+        for (int x = 0; x < cols; x++) {
+            float *current = s + x * block;
+            for (int r = 0; r < block; r++) {
+                current[r] = gain * current[r] + a1 * current[r - block] +
+                  a2 * current[r - 2 * block] + a3 * current[r - 3 * block];
+            }
+        }
+
+        // Anti-causal pass, starting from the steady state of the last pixel
+        for (int r = 0; r < block; r++) {
+            float last = s[(cols - 1) * block + r];
+            s[cols * block + r] = last;
+            s[(cols + 1) * block + r] = last;
+            s[(cols + 2) * block + r] = last;
+        }
+
+        for (int x = cols - 1; x >= 0; x--) {
+            float *current = s + x * block;
+            for (int r = 0; r < block; r++) {
+                current[r] = gain * current[r] + a1 * current[r + block] +
+                  a2 * current[r + 2 * block] + a3 * current[r + 3 * block];
+            }
+        }
+
+        for (int r = 0; r < rows; r++) {
+            float *row = this->buffer.ptr<float>(y0 + r);
+            for (int x = 0; x < cols; x++) {
+                row[x] = s[x * block + r];
+            }
+        }
+    }
+}
+
+void RecursiveGaussian::filter_columns_residual(const Mat &image, Mat &output, int begin,
+  int end) {
+
+    const int rows = image.rows;
+    const int width = end - begin;
+    const float gain = this->gain;
+    const float a1 = this->feedback[0];
+    const float a2 = this->feedback[1];
+    const float a3 = this->feedback[2];
+
+    if (width <= 0) {
+        return;
+    }
+
+    // The recursion runs along y, and each step updates the whole row of columns [begin, end)
+    vector<float> border(3 * width);
+    const float *previous[3];
+
+    // Causal pass, in place, starting from the steady state of the first row
+    const float *first = this->buffer.ptr<float>(0) + begin;
+    std::copy(first, first + width, border.begin());
+    previous[0] = previous[1] = previous[2] = &border[0];
+
+    for (int y = 0; y < rows; y++) {
+        float *current = this->buffer.ptr<float>(y) + begin;
+        const float *p1 = previous[0];
+        const float *p2 = previous[1];
+        const float *p3 = previous[2];
+
+        for (int x = 0; x < width; x++) {
+            current[x] = gain * current[x] + a1 * p1[x] + a2 * p2[x] + a3 * p3[x];
+        }
+
+        previous[2] = previous[1];
+        previous[1] = previous[0];
+        previous[0] = current;
+    }
+
+    // Anti-causal pass, in place, fused with the residual of each finished row
+    const float *last = this->buffer.ptr<float>(rows - 1) + begin;
+    std::copy(last, last + width, border.begin() + width);
+    previous[0] = previous[1] = previous[2] = &border[width];
+
+    for (int y = rows - 1; y >= 0; y--) {
+        float *current = this->buffer.ptr<float>(y) + begin;
+        const uchar *pixels = image.ptr<uchar>(y) + begin;
+        uchar *residual = output.ptr<uchar>(y) + begin;
+        const float *p1 = previous[0];
+        const float *p2 = previous[1];
+        const float *p3 = previous[2];
+
+        for (int x = 0; x < width; x++) {
+            float value = gain * current[x] + a1 * p1[x] + a2 * p2[x] + a3 * p3[x];
+            current[x] = value;
+
+            // The filtered image is rounded to 8 bits before the subtraction, as with -filter 1
+            int difference = pixels[x] - static_cast<int>(value + 0.5f);
+            residual[x] = static_cast<uchar>(difference > 0 ? difference : 0);
+        }
+
+        previous[2] = previous[1];
+        previous[1] = previous[0];
+        previous[0] = current;
+    }
+}
@@ -0,0 +1,89 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef RECURSIVEGAUSSIAN_H_
+#define RECURSIVEGAUSSIAN_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+// Number of rows filtered together by the horizontal pass, so that the recursion along each row
+// is vectorized across the rows of the block
+#define RECURSIVE_GAUSSIAN_BLOCK 16
+
+// Class liable for the residual noise image - gaussian(image) computed by the recursive
+// (IIR) approximation of the gaussian filter of Young and van Vliet (1995), used with -filter 2.
+// Each pass is a causal and an anti-causal filter of third order, so the cost per pixel does not
+// depend on sigma. The borders are extended by replicating the first and last pixels (the exact
+// filter of -filter 1 reflects them). The deviation from the exact gaussian is measured by
+// VisualRhythmValidate.
+class RecursiveGaussian {
+
+private:
+
+    // Standard deviation of the gaussian
+    float sigma;
+
+    // Gain of the input and feedback coefficients of the recursion
+    float gain;
+    float feedback[3];
+
+    // Filtered image in single precision
+    Mat buffer;
+
+public:
+
+    // Constructor
+    RecursiveGaussian();
+
+    // To set the standard deviation of the gaussian (values below 0.5 are taken as 0.5)
+    void set_sigma(float sigma);
+
+    // To compute the residual of an 8-bit image, saturated at zero as cv::subtract
+    void compute_residual(const Mat &image, Mat &output);
+
+    // To allocate the buffer of an image, before the passes are called for parts of the image
+    void prepare(const Mat &image);
+
+    // To filter the rows [begin, end) of the image along the rows, writing the buffer
+    void filter_rows(const Mat &image, int begin, int end);
+
+    // To filter the columns [begin, end) of the buffer along the columns, writing the residual
+    // of these columns in the output (which must have the size of the image)
+    void filter_columns_residual(const Mat &image, Mat &output, int begin, int end);
+
+};
+
+#endif /* RECURSIVEGAUSSIAN_H_ */
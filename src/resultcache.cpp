@@ -0,0 +1,196 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "resultcache.h"
+#include "checksum.h"
+
+#include <cstdio>
+
+#include <sys/stat.h>
+
+// Largest length of the description of the parameters of an extraction
+#define DESCRIPTION_LENGTH 512
+
+// To get the name of the file storing the key of an output
+static string get_key_filename(const Parameters &parameters) {
+    return parameters.output_image + ".key";
+}
+
+// To get the size and the modification time of a file
+static bool get_file_status(const string &filename, long long &size, long long &time) {
+    struct stat file_stat;
+
+    if (stat(filename.c_str(), &file_stat) != 0) {
+        return false;
+    }
+
+    size = file_stat.st_size;
+    time = file_stat.st_mtim.tv_sec * 1000000000LL + file_stat.st_mtim.tv_nsec;
+
+    return true;
+}
+
+bool describe_parameters(const Parameters &parameters, string &description) {
+    uint64_t model_checksum = 0;
+    long long model_size = 0;
+
+    if (!parameters.score_model.empty() &&
+          !compute_file_checksum(parameters.score_model, model_checksum, model_size)) {
+        return false;
+    }
+
+    char fields[DESCRIPTION_LENGTH];
+    int length = snprintf(fields, sizeof(fields),
+      "type %d frames %d roi %d color %d filter %d kernel %d variance %.9g fast %d batch %d "
+      "fusion %d model %016llx interval %d accept %.9g reject %.9g windows %d %d %d "
+      "streaming %d triage %d statistics %d", parameters.visual_rhythm_type,
+      parameters.frame_number, parameters.roi_width, parameters.color_space, parameters.filter,
+      parameters.kernel_size, parameters.variance, parameters.fast_spectrum,
+      parameters.spectrum_batch, parameters.row_fusion,
+      static_cast<unsigned long long>(model_checksum), parameters.score_interval,
+      parameters.accept_threshold, parameters.reject_threshold, parameters.window_length,
+      parameters.window_stride, parameters.max_windows, parameters.streaming_output,
+      parameters.triage, parameters.row_statistics);
+
+    description = string(fields, length);
+
+    return true;
+}
+
+// To compute the key from the parameters that change the output and the checksum of the video
+static bool compute_key(const Parameters &parameters, ResultKey &key) {
+    string description = "";
+
+    if (!describe_parameters(parameters, description)) {
+        return false;
+    }
+
+    Checksum stream(ALGORITHM_VERSION);
+    stream.update(description.data(), description.size());
+    stream.update(&key.video_checksum, sizeof(key.video_checksum));
+
+    key.key = stream.get_digest();
+
+    return true;
+}
+
+// To read the key recorded alongside an output, with the size and the checksum of the output
+static bool read_key_file(const string &filename, ResultKey &key, long long &output_size,
+  uint64_t &output_checksum) {
+
+    FILE *file = fopen(filename.c_str(), "r");
+    unsigned long long fields[3] = {0, 0, 0};
+
+    if (file == NULL) {
+        return false;
+    }
+
+    int field_number = fscanf(file, "%llx %lld %lld %llx %lld %llx", &fields[0],
+      &key.video_size, &key.video_time, &fields[1], &output_size, &fields[2]);
+
+    fclose(file);
+
+    key.key = fields[0];
+    key.video_checksum = fields[1];
+    output_checksum = fields[2];
+
+    return field_number == 6;
+}
+
+bool is_cached_result(const Parameters &parameters, ResultKey &key) {
+    ResultKey recorded;
+    long long output_size = 0;
+    uint64_t output_checksum = 0;
+
+    key.key = 0;
+    key.video_checksum = 0;
+
+    if (!get_file_status(parameters.input_video, key.video_size, key.video_time)) {
+        return false;
+    }
+
+    bool is_recorded = read_key_file(get_key_filename(parameters), recorded, output_size,
+      output_checksum);
+
+    // A video with the recorded size and time is not read again
+    if (is_recorded && recorded.video_size == key.video_size &&
+          recorded.video_time == key.video_time) {
+        key.video_checksum = recorded.video_checksum;
+    } else {
+        long long size = 0;
+
+        if (!compute_file_checksum(parameters.input_video, key.video_checksum, size)) {
+            return false;
+        }
+    }
+
+    if (!compute_key(parameters, key) || !is_recorded || key.key != recorded.key) {
+        return false;
+    }
+
+    uint64_t checksum = 0;
+    long long size = 0;
+
+    return compute_file_checksum(parameters.output_image, checksum, size) &&
+      size == output_size && checksum == output_checksum;
+}
+
+bool record_result(const Parameters &parameters, const ResultKey &key) {
+    uint64_t output_checksum = 0;
+    long long output_size = 0;
+
+    if (!compute_file_checksum(parameters.output_image, output_checksum, output_size)) {
+        cout << "Error:record_result():Could not read " << parameters.output_image << endl;
+        return false;
+    }
+
+    // The key is renamed over the old one, so a crash never leaves a key cut in half
+    string filename = get_key_filename(parameters);
+    string temporary = filename + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "w");
+
+    if (file == NULL) {
+        cout << "Error:record_result():Could not write " << temporary << endl;
+        return false;
+    }
+
+    fprintf(file, "%016llx %lld %lld %016llx %lld %016llx\n",
+      static_cast<unsigned long long>(key.key), key.video_size, key.video_time,
+      static_cast<unsigned long long>(key.video_checksum), output_size,
+      static_cast<unsigned long long>(output_checksum));
+
+    if (fclose(file) != 0 || rename(temporary.c_str(), filename.c_str()) != 0) {
+        cout << "Error:record_result():Could not write " << filename << endl;
+        remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
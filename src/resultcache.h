@@ -0,0 +1,77 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef RESULTCACHE_H_
+#define RESULTCACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "parameters.h"
+
+using namespace std;
+
+// Version of the algorithms computing the visual rhythm, increased whenever a change of the code
+// changes the outputs, so the results of older binaries are computed again
+#define ALGORITHM_VERSION 1
+
+// Key of the result of an extraction and the input video it was computed from
+struct ResultKey {
+
+    // Checksum of the parameters, of the content of the video and of the algorithm version
+    uint64_t key;
+
+    // Size of the input video, in bytes
+    long long video_size;
+
+    // Modification time of the input video, in nanoseconds
+    long long video_time;
+
+    // Checksum of the content of the input video
+    uint64_t video_checksum;
+
+};
+
+// To describe the parameters that change the output of an extraction, with the checksum of the
+// score model. The threads, the pipeline and the instruction set only change the speed, so they
+// are left out. Returns false if the score model can not be read.
+bool describe_parameters(const Parameters &parameters, string &description);
+
+// To check whether the output of an extraction is up to date. The key is stored alongside the
+// output, in a file with the name of the output and the extension .key, together with the size
+// and the checksum of the output, so an output changed or cut is computed again. The content of
+// the video is hashed only when its size or its modification time differ from the recorded ones.
+// The key is filled in any case, to be recorded when the extraction is done.
+bool is_cached_result(const Parameters &parameters, ResultKey &key);
+
+// To record the key of an extraction alongside its output
+bool record_result(const Parameters &parameters, const ResultKey &key);
+
+#endif /* RESULTCACHE_H_ */
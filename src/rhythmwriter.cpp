@@ -0,0 +1,110 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "rhythmwriter.h"
+
+#include <iostream>
+
+RhythmWriter::RhythmWriter() {
+    this->file = NULL;
+    this->filename = "";
+    this->cols = 0;
+    this->rows = 0;
+}
+
+RhythmWriter::~RhythmWriter() {
+    close();
+}
+
+bool RhythmWriter::write_header() {
+    // The number of rows is padded, so that the header keeps its size when it is rewritten
+    return fprintf(this->file, "P5\n%d %12ld\n255\n", this->cols, this->rows) > 0;
+}
+
+bool RhythmWriter::open(const string &filename, int height) {
+    close();
+
+    this->filename = filename;
+    this->cols = height;
+    this->rows = 0;
+    this->file = fopen(filename.c_str(), "wb");
+
+    if (this->file == NULL) {
+        cout << "Error:RhythmWriter::open():Could not create " << filename << endl;
+        return false;
+    }
+
+    setvbuf(this->file, NULL, _IOFBF, 1 << 20);
+
+    return write_header();
+}
+
+bool RhythmWriter::write_strip(const Mat &strip) {
+
+    if (this->file == NULL) {
+        return false;
+    }
+
+    transpose(strip, this->transposed);
+
+    for (int y = 0; y < this->transposed.rows; y++) {
+        if (fwrite(this->transposed.ptr<uchar>(y), 1, this->cols, this->file) !=
+              static_cast<size_t>(this->cols)) {
+            cout << "Error:RhythmWriter::write_strip():Could not write " << this->filename << endl;
+            return false;
+        }
+    }
+
+    this->rows += this->transposed.rows;
+
+    return true;
+}
+
+bool RhythmWriter::close() {
+
+    if (this->file == NULL) {
+        return true;
+    }
+
+    bool is_written = (fseek(this->file, 0, SEEK_SET) == 0) && write_header();
+
+    is_written = (fclose(this->file) == 0) && is_written;
+    this->file = NULL;
+
+    if (!is_written) {
+        cout << "Error:RhythmWriter::close():Could not write " << this->filename << endl;
+    }
+
+    return is_written;
+}
+
+bool RhythmWriter::is_opened() const {
+    return this->file != NULL;
+}
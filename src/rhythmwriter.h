@@ -0,0 +1,91 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef RHYTHMWRITER_H_
+#define RHYTHMWRITER_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+#include <cstdio>
+#include <string>
+
+using namespace std;
+using namespace cv;
+
+// Class liable for writing a visual rhythm strip by strip, as the strips are computed, so that
+// the memory used does not depend on the number of frames. The visual rhythm is written as a
+// binary PGM image in a transposed (frame-major) layout: each strip of height x roi_width pixels
+// becomes roi_width rows of the file. Transposing the image gives back the usual orientation.
+class RhythmWriter {
+
+private:
+
+    // Output file
+    FILE *file;
+
+    // Output file name
+    string filename;
+
+    // Number of columns of the file (height of the visual rhythm)
+    int cols;
+
+    // Number of rows written
+    long rows;
+
+    // Transposed strip
+    Mat transposed;
+
+    // To write the PGM header
+    bool write_header();
+
+public:
+
+    // Constructor
+    RhythmWriter();
+
+    // Destructor
+    ~RhythmWriter();
+
+    // To create the output file for a visual rhythm of the given height
+    bool open(const string &filename, int height);
+
+    // To append a strip of height x roi_width pixels
+    bool write_strip(const Mat &strip);
+
+    // To update the header with the number of rows written and close the file
+    bool close();
+
+    // Is the file opened?
+    bool is_opened() const;
+
+};
+
+#endif /* RHYTHMWRITER_H_ */
@@ -0,0 +1,153 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "rowstatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+// Number of bits of a pixel value dropped to get its bin of the histogram
+#define ROW_HISTOGRAM_SHIFT 5
+
+RowStatistics::RowStatistics() {
+    this->rows = 0;
+    this->count = 0;
+}
+
+void RowStatistics::open(int height) {
+    this->rows = height;
+    this->count = 0;
+    this->means.assign(height, 0.0);
+    this->deviations.assign(height, 0.0);
+    this->minimums.assign(height, 255);
+    this->maximums.assign(height, 0);
+    this->histograms.assign(height * ROW_HISTOGRAM_BINS, 0);
+}
+
+void RowStatistics::close() {
+    this->rows = 0;
+    this->count = 0;
+}
+
+bool RowStatistics::is_opened() const {
+    return this->rows > 0;
+}
+
+void RowStatistics::update(const Mat &strip) {
+
+    if (strip.empty() || strip.rows != this->rows) {
+        cout << "Error:RowStatistics::update():Invalid strip size" << endl;
+        return;
+    }
+
+    const int width = strip.cols;
+    const long long total = this->count + width;
+
+    for (int y = 0; y < this->rows; y++) {
+        const uchar *src = strip.ptr<uchar>(y);
+        long long *histogram = &this->histograms[y * ROW_HISTOGRAM_BINS];
+        long long sum = 0, squares = 0;
+        uchar minimum = this->minimums[y], maximum = this->maximums[y];
+
+        // The sums of the strip are exact, the running statistics are merged once per strip
+        for (int x = 0; x < width; x++) {
+            int value = src[x];
+
+            sum += value;
+            squares += value * value;
+            minimum = std::min(minimum, src[x]);
+            maximum = std::max(maximum, src[x]);
+            histogram[value >> ROW_HISTOGRAM_SHIFT]++;
+        }
+
+        double strip_mean = static_cast<double>(sum) / width;
+        double strip_deviation = squares - strip_mean * sum;
+        double delta = strip_mean - this->means[y];
+
+        this->means[y] += delta * width / total;
+        this->deviations[y] += strip_deviation + delta * delta * this->count * width / total;
+        this->minimums[y] = minimum;
+        this->maximums[y] = maximum;
+    }
+
+    this->count = total;
+}
+
+void RowStatistics::get_descriptor(vector<float> &descriptor) const {
+    descriptor.assign(this->rows * ROW_FEATURE_NUMBER, 0.0f);
+
+    if (this->count == 0) {
+        return;
+    }
+
+    for (int y = 0; y < this->rows; y++) {
+        float *features = &descriptor[y * ROW_FEATURE_NUMBER];
+        const long long *histogram = &this->histograms[y * ROW_HISTOGRAM_BINS];
+
+        // The rounding of the merges may leave a constant row with a tiny negative deviation
+        double variance = std::max(this->deviations[y], 0.0) / this->count;
+
+        features[0] = static_cast<float>(this->means[y] / 255.0);
+        features[1] = static_cast<float>(std::sqrt(variance) / 255.0);
+        features[2] = this->minimums[y] / 255.0f;
+        features[3] = this->maximums[y] / 255.0f;
+
+        for (int b = 0; b < ROW_HISTOGRAM_BINS; b++) {
+            features[4 + b] = static_cast<float>(static_cast<double>(histogram[b]) / this->count);
+        }
+    }
+}
+
+bool RowStatistics::save(const string &filename) const {
+    vector<float> descriptor;
+    FILE *file = fopen(filename.c_str(), "w");
+
+    if (file == NULL) {
+        cout << "Error:RowStatistics::save():Could not create " << filename << endl;
+        return false;
+    }
+
+    get_descriptor(descriptor);
+
+    for (size_t i = 0; i < descriptor.size(); i++) {
+        fprintf(file, (i == 0) ? "%.6g" : " %.6g", descriptor[i]);
+    }
+
+    fprintf(file, "\n");
+
+    if (fclose(file) != 0) {
+        cout << "Error:RowStatistics::save():Could not write " << filename << endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef ROWSTATISTICS_H_
+#define ROWSTATISTICS_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+// Number of bins of the histogram of each row
+#define ROW_HISTOGRAM_BINS 8
+
+// Number of features of each row: mean, standard deviation, minimum, maximum and the histogram
+#define ROW_FEATURE_NUMBER (4 + ROW_HISTOGRAM_BINS)
+
+// Class liable for the running statistics of each row of a visual rhythm over time, updated strip
+// by strip, so that the memory used depends on the height of the visual rhythm and not on the
+// number of frames. The mean and the variance are merged strip by strip with the pairwise update
+// of Welford's algorithm (Chan et al.), which is stable for long videos. The descriptor holds
+// ROW_FEATURE_NUMBER values for each row, all of them between 0 and 1.
+class RowStatistics {
+
+private:
+
+    // Number of rows of the visual rhythm (0 means closed)
+    int rows;
+
+    // Number of pixels of each row given so far
+    long long count;
+
+    // Running mean and sum of the squared deviations of each row
+    vector<double> means;
+    vector<double> deviations;
+
+    // Smallest and largest value of each row
+    vector<uchar> minimums;
+    vector<uchar> maximums;
+
+    // Histogram of each row, ROW_HISTOGRAM_BINS counts per row
+    vector<long long> histograms;
+
+public:
+
+    // Constructor
+    RowStatistics();
+
+    // To start the statistics of a visual rhythm of the given height
+    void open(int height);
+
+    // To drop the statistics
+    void close();
+
+    // Are the statistics being computed?
+    bool is_opened() const;
+
+    // To add a strip of height x roi_width pixels
+    void update(const Mat &strip);
+
+    // To get the descriptor: the features of each row, one row after the other
+    void get_descriptor(vector<float> &descriptor) const;
+
+    // To save the descriptor as a line of text, with its values separated by spaces
+    bool save(const string &filename) const;
+
+};
+
+#endif /* ROWSTATISTICS_H_ */
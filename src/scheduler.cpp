@@ -0,0 +1,548 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "scheduler.h"
+#include "checksum.h"
+#include "dataset.h"
+#include "extraction.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include <pthread.h>
+#include <sched.h>
+
+// Largest number of measures averaged by an entry of the frame cost, so it follows changes
+#define MAX_COST_MEASURES 8
+
+// To sort the videos from the longest to the shortest
+static bool is_longer(const BatchJob &a, const BatchJob &b) {
+    return a.work > b.work;
+}
+
+Scheduler::Scheduler() {
+    this->core_number = 1;
+    this->pinning = false;
+    this->verbose = true;
+    this->journal_filename = "";
+    this->shard_index = 0;
+    this->shard_number = 1;
+    this->dataset_filename = "";
+    this->next_job = 0;
+    this->remaining_work = 0.0;
+}
+
+void Scheduler::set_core_number(int core_number) {
+    this->core_number = core_number;
+}
+
+void Scheduler::set_pinning(bool pinning) {
+    this->pinning = pinning;
+}
+
+void Scheduler::set_verbose(bool verbose) {
+    this->verbose = verbose;
+}
+
+void Scheduler::set_journal(const string &filename) {
+    this->journal_filename = filename;
+}
+
+void Scheduler::set_shard(int index, int number) {
+    this->shard_index = index;
+    this->shard_number = number;
+}
+
+void Scheduler::set_dataset(const string &filename) {
+    this->dataset_filename = filename;
+}
+
+bool Scheduler::load_manifest(const string &filename, const Parameters &defaults) {
+    ifstream manifest(filename.c_str());
+    string line = "";
+    int line_number = 0;
+
+    if (!manifest.is_open()) {
+        cout << "Error:Scheduler::load_manifest():Could not open " << filename << endl;
+        return false;
+    }
+
+    this->jobs.clear();
+    this->outputs.clear();
+
+    while (getline(manifest, line)) {
+        BatchJob job;
+
+        line_number++;
+
+        if (line.find_first_not_of(" \t\r") == string::npos || line[0] == '#') {
+            continue;
+        }
+
+        uint64_t line_key = compute_checksum(line.data(), line.size());
+
+        // Every shard reads the whole manifest, so all of them agree on the assignment. Only the
+        // lines of this shard are verified, which creates their output directories
+        if (line_key % this->shard_number != static_cast<uint64_t>(this->shard_index)) {
+            continue;
+        }
+
+        // Each video starts from the options of the command line
+        job.parameters = defaults;
+        job.parameters.batch = "";
+        job.parameters.input_video = "";
+        job.parameters.output_image = "";
+
+        if (parse_request_line(line, job.parameters) || verify_command_line(job.parameters)) {
+            cout << "Error:Scheduler::load_manifest():Invalid parameters in line " << line_number;
+            cout << " of " << filename << endl;
+            return false;
+        }
+
+        job.parameters.verbose = false;
+
+        // The options of the command line take part in the job as much as its line, so a job is
+        // computed again when any of them changes
+        string description = "";
+
+        if (!describe_parameters(job.parameters, description)) {
+            cout << "Error:Scheduler::load_manifest():Could not read the score model of line ";
+            cout << line_number << " of " << filename << endl;
+            return false;
+        }
+
+        description += " input " + job.parameters.input_video + " output " +
+          job.parameters.output_image;
+        job.key = compute_checksum(description.data(), description.size(), ALGORITHM_VERSION);
+
+        job.work = 0.0;
+        job.frame_pixels = 0.0;
+        job.thread_number = 1;
+        job.elapsed = 0.0;
+        job.is_done = false;
+
+        this->jobs.push_back(job);
+        this->outputs.push_back(job.parameters.output_image);
+    }
+
+    return true;
+}
+
+bool Scheduler::run() {
+    vector<std::thread> runners;
+    int done_number = 0;
+    int skipped_number = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (!this->journal_filename.empty()) {
+
+        if (!this->journal.open(this->journal_filename)) {
+            return false;
+        }
+
+        skipped_number = skip_completed_jobs();
+    }
+
+    skipped_number += skip_cached_jobs();
+
+    estimate_work();
+
+    this->next_job = 0;
+    this->free_cores.assign(this->core_number, true);
+    this->frame_cost.assign(this->core_number + 1, 0.0);
+    this->measure_number.assign(this->core_number + 1, 0);
+
+    // Each running video takes at least one core, so there is one runner per core
+    int runner_number = std::min(this->core_number, static_cast<int>(this->jobs.size()));
+
+    for (int i = 0; i < runner_number; i++) {
+        runners.push_back(std::thread(&Scheduler::runner_loop, this));
+    }
+
+    for (size_t i = 0; i < runners.size(); i++) {
+        runners[i].join();
+    }
+
+    for (size_t i = 0; i < this->jobs.size(); i++) {
+        if (this->jobs[i].is_done) {
+            done_number++;
+        } else {
+            cout << "Error:Scheduler::run():Could not compute the visual rhythm of ";
+            cout << this->jobs[i].parameters.input_video << endl;
+        }
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (this->verbose) {
+        cout << "Computed " << done_number << " of " << this->jobs.size();
+        cout << " visual rhythms in " << elapsed.count() << " ms";
+
+        if (skipped_number > 0) {
+            cout << " (" << skipped_number << " completed before)";
+        }
+
+        cout << endl;
+    }
+
+    if (done_number != static_cast<int>(this->jobs.size())) {
+        return false;
+    }
+
+    return this->dataset_filename.empty() || write_dataset();
+}
+
+int Scheduler::skip_completed_jobs() {
+    vector<BatchJob> pending;
+
+    // The outputs are checked again, a video whose output was cut or changed is computed again
+    for (size_t i = 0; i < this->jobs.size(); i++) {
+        BatchJob &job = this->jobs[i];
+
+        if (!this->journal.is_completed(job.key, job.parameters.output_image)) {
+            pending.push_back(job);
+        }
+    }
+
+    int skipped_number = static_cast<int>(this->jobs.size() - pending.size());
+
+    this->jobs.swap(pending);
+
+    return skipped_number;
+}
+
+int Scheduler::skip_cached_jobs() {
+    vector<BatchJob> pending;
+
+    for (size_t i = 0; i < this->jobs.size(); i++) {
+        BatchJob &job = this->jobs[i];
+
+        if (job.parameters.cache == 0 || !is_cached_result(job.parameters, job.result_key)) {
+            pending.push_back(job);
+        }
+    }
+
+    int skipped_number = static_cast<int>(this->jobs.size() - pending.size());
+
+    this->jobs.swap(pending);
+
+    return skipped_number;
+}
+
+bool Scheduler::write_dataset() {
+    DatasetWriter writer;
+    vector<string> names = this->outputs;
+
+    std::sort(names.begin(), names.end());
+
+    if (!writer.open(this->dataset_filename)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!writer.add_file(names[i], names[i])) {
+            return false;
+        }
+    }
+
+    if (!writer.close()) {
+        return false;
+    }
+
+    if (this->verbose) {
+        cout << "Wrote " << names.size() << " visual rhythms to " << this->dataset_filename;
+        cout << endl;
+    }
+
+    return true;
+}
+
+void Scheduler::runner_loop() {
+
+    // Objects reused by every video computed by this runner
+    Video processor;
+    VisualRhythm visual_rhythm;
+    ThreadPool thread_pool;
+    int pool_thread_number = 0;
+
+    visual_rhythm.set_thread_pool(&thread_pool);
+
+    set_trace_thread_name("Batch runner");
+
+    while (true) {
+        vector<int> cores;
+        size_t index = 0;
+        int thread_number = 1;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            while (true) {
+
+                if (this->next_job >= this->jobs.size()) {
+                    return;
+                }
+
+                thread_number = choose_thread_number(this->jobs[this->next_job]);
+
+                if (take_cores(thread_number, cores)) {
+                    break;
+                }
+
+                this->condition.wait(lock);
+            }
+
+            index = this->next_job++;
+            this->jobs[index].thread_number = thread_number;
+        }
+
+        BatchJob &job = this->jobs[index];
+
+        // Pinned threads are created again, so the workers of the pool inherit the new cores
+        if (this->pinning) {
+            pin_thread(cores);
+        }
+
+        if (this->pinning || thread_number != pool_thread_number) {
+            thread_pool.start(thread_number);
+            pool_thread_number = thread_number;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        bool is_done = false;
+
+        {
+            TraceScope trace("Scheduler::compute_visual_rhythm");
+            is_done = compute_visual_rhythm(job.parameters, processor, visual_rhythm);
+        }
+
+        // The output is complete once it is recorded, so a crash before this line redoes it
+        if (is_done && this->journal.is_open()) {
+            is_done = this->journal.record(job.key, job.parameters.output_image);
+        }
+
+        if (is_done && job.parameters.cache == 1) {
+            is_done = record_result(job.parameters, job.result_key);
+        }
+
+        std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+
+            job.elapsed = elapsed.count();
+            job.is_done = is_done;
+            this->remaining_work -= job.work;
+
+            if (is_done) {
+                update_frame_cost(job, job.elapsed, visual_rhythm.get_frame_number());
+            }
+
+            release_cores(cores);
+
+            if (this->verbose && is_done) {
+                cout << job.parameters.output_image << " (" << thread_number << " threads, ";
+                cout << job.elapsed << " ms";
+
+                if (job.parameters.skip_duplicates == 1) {
+                    cout << ", " << visual_rhythm.get_duplicate_frame_number() << " duplicates";
+                }
+
+                cout << ")" << endl;
+            }
+        }
+
+        this->condition.notify_all();
+    }
+}
+
+void Scheduler::estimate_work() {
+    Video processor;
+
+    this->remaining_work = 0.0;
+
+    for (size_t i = 0; i < this->jobs.size(); i++) {
+        BatchJob &job = this->jobs[i];
+
+        job.work = 0.0;
+        job.frame_pixels = 0.0;
+
+        if (!processor.set_input_video(job.parameters.input_video.c_str())) {
+            continue;
+        }
+
+        double frames = static_cast<double>(processor.get_total_frame_count());
+
+        if (frames <= 0.0 || frames > job.parameters.frame_number) {
+            frames = job.parameters.frame_number;
+        }
+
+        job.frame_pixels = static_cast<double>(processor.get_frame_width()) *
+          processor.get_frame_height();
+        job.work = frames * job.frame_pixels;
+        this->remaining_work += job.work;
+    }
+
+    std::stable_sort(this->jobs.begin(), this->jobs.end(), is_longer);
+}
+
+int Scheduler::choose_thread_number(const BatchJob &job) const {
+    int free_number = static_cast<int>(std::count(this->free_cores.begin(),
+      this->free_cores.end(), true));
+    int pending_number = static_cast<int>(this->jobs.size() - this->next_job);
+    int thread_number = 1;
+
+    if (free_number == 0) {
+        return 1;
+    }
+
+    // Time of the batch if the remaining work was spread over all cores, one thread per video
+    double target = this->remaining_work * get_frame_cost(1) / this->core_number;
+
+    // A straggler gets the fewest threads per frame that bring it within the target
+    while (thread_number < free_number &&
+      job.work * get_frame_cost(thread_number) > target) {
+        thread_number++;
+    }
+
+    // At the tail of the batch the cores left idle are shared by the last videos
+    if (pending_number < free_number) {
+        thread_number = std::max(thread_number, free_number / pending_number);
+    }
+
+    return thread_number;
+}
+
+double Scheduler::get_frame_cost(int thread_number) const {
+    int size = static_cast<int>(this->frame_cost.size());
+
+    if (this->measure_number[thread_number] > 0) {
+        return this->frame_cost[thread_number];
+    }
+
+    // Without a measure, a linear speedup from the closest measured number of threads
+    for (int distance = 1; distance < size; distance++) {
+        int lower = thread_number - distance;
+        int upper = thread_number + distance;
+
+        if (lower >= 1 && this->measure_number[lower] > 0) {
+            return this->frame_cost[lower] * lower / thread_number;
+        }
+
+        if (upper < size && this->measure_number[upper] > 0) {
+            return this->frame_cost[upper] * upper / thread_number;
+        }
+    }
+
+    return 1.0 / thread_number;
+}
+
+bool Scheduler::take_cores(int thread_number, vector<int> &cores) {
+    int size = static_cast<int>(this->free_cores.size());
+
+    cores.clear();
+
+    // Neighbour cores first, they usually share caches and memory node
+    for (int first = 0; first + thread_number <= size && cores.empty(); first++) {
+        int last = first;
+
+        while (last < first + thread_number && this->free_cores[last]) {
+            last++;
+        }
+
+        if (last == first + thread_number) {
+            for (int core = first; core < last; core++) {
+                cores.push_back(core);
+            }
+        }
+    }
+
+    if (cores.empty()) {
+        for (int core = 0; core < size && static_cast<int>(cores.size()) < thread_number; core++) {
+            if (this->free_cores[core]) {
+                cores.push_back(core);
+            }
+        }
+
+        if (static_cast<int>(cores.size()) < thread_number) {
+            cores.clear();
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < cores.size(); i++) {
+        this->free_cores[cores[i]] = false;
+    }
+
+    return true;
+}
+
+void Scheduler::release_cores(const vector<int> &cores) {
+    for (size_t i = 0; i < cores.size(); i++) {
+        this->free_cores[cores[i]] = true;
+    }
+}
+
+void Scheduler::update_frame_cost(const BatchJob &job, double elapsed, int frames) {
+    int thread_number = job.thread_number;
+    double pixels = job.frame_pixels * frames;
+
+    if (pixels <= 0.0) {
+        return;
+    }
+
+    double cost = elapsed / (pixels / 1e6);
+    int n = std::min(this->measure_number[thread_number], MAX_COST_MEASURES - 1);
+
+    this->frame_cost[thread_number] += (cost - this->frame_cost[thread_number]) / (n + 1);
+    this->measure_number[thread_number]++;
+}
+
+bool pin_thread(const vector<int> &cores) {
+    cpu_set_t set;
+    int core_number = static_cast<int>(std::thread::hardware_concurrency());
+
+    if (core_number < 1) {
+        return false;
+    }
+
+    CPU_ZERO(&set);
+
+    for (size_t i = 0; i < cores.size(); i++) {
+        CPU_SET(cores[i] % core_number, &set);
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
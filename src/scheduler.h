@@ -0,0 +1,196 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "journal.h"
+#include "parameters.h"
+#include "resultcache.h"
+#include "threadpool.h"
+#include "video.h"
+#include "visualrhythm.h"
+
+// Video of a batch and the measures of its extraction
+struct BatchJob {
+
+    // Parameters of the extraction
+    Parameters parameters;
+
+    // Key of the video in the journal, the checksum of its effective parameters, input and output
+    uint64_t key;
+
+    // Key of the result, from the content of the video and the parameters
+    ResultKey result_key;
+
+    // Estimated work, in pixels of all frames to be processed
+    double work;
+
+    // Pixels of a frame
+    double frame_pixels;
+
+    // Number of threads used to compute each frame
+    int thread_number;
+
+    // Time spent, in milliseconds
+    double elapsed;
+
+    // Was the visual rhythm computed?
+    bool is_done;
+
+};
+
+// Class liable for computing the visual rhythms of a batch of videos. The cores are shared
+// between videos computed at the same time (one thread each) and the threads that compute each
+// frame of a video. The videos are started from the longest one, and a video that would finish
+// long after the others (a straggler) receives more threads per frame. The cost of a frame is
+// measured while the batch runs, so the estimates follow the real speedup of the frame threads.
+class Scheduler {
+
+private:
+
+    // Videos of the batch
+    vector<BatchJob> jobs;
+
+    // Number of cores kept busy
+    int core_number;
+
+    // To pin the threads of each video to the cores it was given
+    bool pinning;
+
+    // To print the progress messages
+    bool verbose;
+
+    // Journal of the completed videos, used to resume an interrupted batch
+    Journal journal;
+    string journal_filename;
+
+    // Shard of the batch computed by this scheduler and number of shards
+    int shard_index;
+    int shard_number;
+
+    // Dataset container written at the end of the batch (empty means no container)
+    string dataset_filename;
+
+    // Output files of the videos of the shard, including the ones completed before
+    vector<string> outputs;
+
+    // Index of the next video to be started
+    size_t next_job;
+
+    // Work of the videos not yet finished
+    double remaining_work;
+
+    // Cores not used by the running videos
+    vector<bool> free_cores;
+
+    // Measured milliseconds per million pixels, indexed by the number of threads per frame
+    vector<double> frame_cost;
+
+    // Number of measures of each entry of frame_cost
+    vector<int> measure_number;
+
+    // Mutex protecting the state of the batch
+    std::mutex mutex;
+
+    // Condition used to wake up the runners when cores are released
+    std::condition_variable condition;
+
+    // To run videos until the batch is over
+    void runner_loop();
+
+    // To remove the videos completed by a previous run of the batch, returns their number
+    int skip_completed_jobs();
+
+    // To remove the videos whose outputs are up to date in the result cache, returns their number
+    int skip_cached_jobs();
+
+    // To write the outputs of the shard into the dataset container, in the order of their names
+    bool write_dataset();
+
+    // To estimate the work of every video
+    void estimate_work();
+
+    // To get the number of threads per frame of the next video (called with the mutex locked)
+    int choose_thread_number(const BatchJob &job) const;
+
+    // To get the expected milliseconds per million pixels with a number of threads per frame
+    double get_frame_cost(int thread_number) const;
+
+    // To take cores for a video, returns false if there are not enough free cores
+    bool take_cores(int thread_number, vector<int> &cores);
+
+    // To release the cores of a video
+    void release_cores(const vector<int> &cores);
+
+    // To update the measured cost of a frame
+    void update_frame_cost(const BatchJob &job, double elapsed, int frames);
+
+public:
+
+    // Constructor
+    Scheduler();
+
+    // To set the number of cores kept busy
+    void set_core_number(int core_number);
+
+    // To set whether the threads are pinned to cores
+    void set_pinning(bool pinning);
+
+    // To set whether progress messages are printed
+    void set_verbose(bool verbose);
+
+    // To set the journal of the completed videos (empty means no journal)
+    void set_journal(const string &filename);
+
+    // To set the shard of the batch computed by this scheduler
+    void set_shard(int index, int number);
+
+    // To set the dataset container written at the end of the batch (empty means no container)
+    void set_dataset(const string &filename);
+
+    // To read the videos of the batch, one line per video with the options of the command line
+    bool load_manifest(const string &filename, const Parameters &defaults);
+
+    // To compute the visual rhythms of all videos, returns false if any of them failed
+    bool run();
+
+};
+
+// To pin the calling thread to a set of cores, the threads it creates inherit the set
+bool pin_thread(const vector<int> &cores);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,150 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "scorer.h"
+#include "descriptor.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+LinearScorer::LinearScorer() {
+    this->bins = 16;
+    this->distance = 1;
+    this->bias = 0.0f;
+}
+
+bool LinearScorer::load(const string &filename) {
+    ifstream model(filename.c_str());
+    string line = "";
+    int bins = 16;
+    int distance = 1;
+    float bias = 0.0f;
+    vector<float> weights;
+
+    if (!model.is_open()) {
+        cout << "Error:LinearScorer::load():Could not open " << filename << endl;
+        return false;
+    }
+
+    while (getline(model, line)) {
+        istringstream fields(line);
+        string key = "";
+        float value = 0.0f;
+
+        if (!(fields >> key) || key[0] == '#') {
+            continue;
+        }
+
+        if (key.compare("bins") == 0) {
+            fields >> bins;
+        } else if (key.compare("distance") == 0) {
+            fields >> distance;
+        } else if (key.compare("bias") == 0) {
+            fields >> bias;
+        } else if (key.compare("weights") == 0) {
+            // The weights may continue on the next lines
+            while (fields >> value) {
+                weights.push_back(value);
+            }
+            while (model >> value) {
+                weights.push_back(value);
+            }
+        } else {
+            cout << "Error:LinearScorer::load():Unknown field " << key << " in " << filename << endl;
+            return false;
+        }
+    }
+
+    if (bins < 1 || bins > 256 || distance < 1 ||
+          weights.size() != static_cast<size_t>(4 * bins * bins)) {
+        cout << "Error:LinearScorer::load():Invalid model in " << filename << endl;
+        return false;
+    }
+
+    set_model(bins, distance, bias, weights);
+
+    return true;
+}
+
+bool LinearScorer::save(const string &filename) const {
+    ofstream model(filename.c_str());
+
+    if (!model.is_open()) {
+        cout << "Error:LinearScorer::save():Could not open " << filename << endl;
+        return false;
+    }
+
+    model << "bins " << this->bins << endl;
+    model << "distance " << this->distance << endl;
+    model << "bias " << this->bias << endl;
+    model << "weights";
+
+    model.precision(9);
+
+    for (size_t i = 0; i < this->weights.size(); i++) {
+        model << ((i % this->bins == 0) ? "\n" : " ") << this->weights[i];
+    }
+
+    model << endl;
+
+    return model.good();
+}
+
+void LinearScorer::set_model(int bins, int distance, float bias, const vector<float> &weights) {
+    this->bins = bins;
+    this->distance = distance;
+    this->bias = bias;
+    this->weights = weights;
+}
+
+bool LinearScorer::is_loaded() const {
+    return !this->weights.empty();
+}
+
+int LinearScorer::get_bins() const {
+    return this->bins;
+}
+
+int LinearScorer::get_distance() const {
+    return this->distance;
+}
+
+float LinearScorer::score(const Mat &image) {
+    double score = this->bias;
+
+    compute_glcm_descriptor(image, this->descriptor, this->bins, this->distance);
+
+    for (size_t i = 0; i < this->weights.size(); i++) {
+        score += this->weights[i] * this->descriptor[i];
+    }
+
+    return static_cast<float>(score);
+}
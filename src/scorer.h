@@ -0,0 +1,98 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef SCORER_H_
+#define SCORER_H_
+
+// It contains the basic data structures, drawing functions and XML support
+#include <opencv2/core/core.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+// Class liable for a linear model on the co-occurrence descriptor of a visual rhythm (see
+// descriptor.h). Positive scores indicate a genuine access and negative scores an attack. The
+// model is a text file with the lines (lines starting with # are ignored):
+//
+//     bins <number of bins>
+//     distance <distance between the pixels>
+//     bias <bias>
+//     weights <4 * bins * bins weights>
+class LinearScorer {
+
+private:
+
+    // Number of bins of the co-occurrence matrices
+    int bins;
+
+    // Distance between the pixels of the co-occurrence matrices
+    int distance;
+
+    // Bias of the linear model
+    float bias;
+
+    // Weights of the linear model
+    vector<float> weights;
+
+    // Descriptor of the last scored image
+    vector<float> descriptor;
+
+public:
+
+    // Constructor
+    LinearScorer();
+
+    // To load the model from a file
+    bool load(const string &filename);
+
+    // To save the model into a file
+    bool save(const string &filename) const;
+
+    // To set the model
+    void set_model(int bins, int distance, float bias, const vector<float> &weights);
+
+    // Was a model loaded?
+    bool is_loaded() const;
+
+    // To get the number of bins of the co-occurrence matrices
+    int get_bins() const;
+
+    // To get the distance between the pixels of the co-occurrence matrices
+    int get_distance() const;
+
+    // To compute the score of an image
+    float score(const Mat &image);
+
+};
+
+#endif /* SCORER_H_ */
@@ -0,0 +1,328 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "server.h"
+#include "extraction.h"
+
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+Server::Server() {
+    this->socket_path = "";
+    this->worker_number = 4;
+    this->thread_number = 1;
+    this->listen_fd = -1;
+    this->stop = false;
+}
+
+Server::~Server() {
+    if (this->listen_fd >= 0) {
+        close(this->listen_fd);
+        unlink(this->socket_path.c_str());
+    }
+}
+
+void Server::set_socket_path(string socket_path) {
+    this->socket_path = socket_path;
+}
+
+void Server::set_worker_number(int worker_number) {
+    this->worker_number = worker_number;
+}
+
+void Server::set_thread_number(int thread_number) {
+    this->thread_number = thread_number;
+}
+
+bool Server::run() {
+    struct sockaddr_un address;
+
+    if (this->socket_path.size() >= sizeof(address.sun_path)) {
+        cout << "Error:Server::run():Socket path too long" << endl;
+        return false;
+    }
+
+    // A client closing its connection must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    this->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (this->listen_fd < 0) {
+        cout << "Error:Server::run():" << strerror(errno) << endl;
+        return false;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, this->socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    unlink(this->socket_path.c_str());
+
+    if (bind(this->listen_fd, (struct sockaddr*) &address, sizeof(address)) < 0 ||
+          listen(this->listen_fd, SOMAXCONN) < 0) {
+        cout << "Error:Server::run():" << strerror(errno) << endl;
+        return false;
+    }
+
+    this->stop = false;
+
+    this->thread_pool.start(this->thread_number);
+
+    for (int i = 0; i < this->worker_number; i++) {
+        this->workers.push_back(std::thread(&Server::worker_loop, this));
+    }
+
+    cout << "Listening on " << this->socket_path << " with " << this->worker_number;
+    cout << " workers" << endl;
+
+    while (!is_stopped()) {
+
+        int fd = accept(this->listen_fd, NULL, NULL);
+
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->pending_connections.push(fd);
+        this->condition.notify_one();
+    }
+
+    stop_it();
+
+    for (size_t i = 0; i < this->workers.size(); i++) {
+        this->workers[i].join();
+    }
+
+    this->workers.clear();
+
+    return true;
+}
+
+void Server::worker_loop() {
+
+    // Objects reused by every request served by this worker
+    Video processor;
+    VisualRhythm visual_rhythm;
+
+    visual_rhythm.set_thread_pool(&this->thread_pool);
+
+    while (true) {
+        int fd = -1;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            while (!this->stop && this->pending_connections.empty()) {
+                this->condition.wait(lock);
+            }
+
+            if (this->pending_connections.empty()) {
+                return;
+            }
+
+            fd = this->pending_connections.front();
+            this->pending_connections.pop();
+            this->open_connections.insert(fd);
+        }
+
+        handle_connection(fd, processor, visual_rhythm);
+
+        // The descriptor is forgotten before closing it, so stop_it() never shuts down a reused one
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->open_connections.erase(fd);
+        }
+
+        close(fd);
+    }
+}
+
+void Server::handle_connection(int fd, Video &processor, VisualRhythm &visual_rhythm) {
+    string buffer = "";
+    string request = "";
+
+    while (!is_stopped() && read_line(fd, buffer, request)) {
+
+        if (request.compare("SHUTDOWN") == 0) {
+            write_line(fd, "OK shutdown");
+            stop_it();
+            return;
+        }
+
+        if (!write_line(fd, handle_request(request, processor, visual_rhythm))) {
+            return;
+        }
+    }
+}
+
+string Server::handle_request(const string &request, Video &processor,
+  VisualRhythm &visual_rhythm) {
+
+    Parameters parameters;
+    ostringstream reply;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    parameters.verbose = false;
+
+    if (parse_request_line(request, parameters) || verify_command_line(parameters)) {
+        return "ERROR Invalid parameters";
+    }
+
+    // A request failing inside OpenCV must not stop the other workers, the next request of this
+    // worker resets the objects
+    try {
+        if (!compute_visual_rhythm(parameters, processor, visual_rhythm)) {
+            return "ERROR Could not compute the visual rhythm of " + parameters.input_video;
+        }
+    } catch (const cv::Exception &exception) {
+        return "ERROR Could not compute the visual rhythm of " + parameters.input_video + ": " +
+          exception.err;
+    } catch (const std::exception &exception) {
+        return "ERROR Could not compute the visual rhythm of " + parameters.input_video + ": " +
+          exception.what();
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    reply << "OK " << parameters.output_image << " " << elapsed.count();
+
+    return reply.str();
+}
+
+void Server::stop_it() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (!this->stop) {
+        this->stop = true;
+
+        // To wake up the accept() of the main thread
+        shutdown(this->listen_fd, SHUT_RDWR);
+
+        // To wake up the workers waiting for a request on an idle connection
+        for (set<int>::iterator it = this->open_connections.begin();
+              it != this->open_connections.end(); ++it) {
+            shutdown(*it, SHUT_RDWR);
+        }
+    }
+
+    this->condition.notify_all();
+}
+
+bool Server::is_stopped() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->stop;
+}
+
+bool read_line(int fd, string &buffer, string &line) {
+    char chunk[4096];
+    size_t end = 0;
+
+    while ((end = buffer.find('\n')) == string::npos) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        buffer.append(chunk, n);
+    }
+
+    line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+
+    if (!line.empty() && line[line.size() - 1] == '\r') {
+        line.erase(line.size() - 1);
+    }
+
+    return true;
+}
+
+bool write_line(int fd, const string &line) {
+    string data = line + "\n";
+    size_t written = 0;
+
+    while (written < data.size()) {
+        ssize_t n = write(fd, data.c_str() + written, data.size() - written);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        written += n;
+    }
+
+    return true;
+}
+
+int connect_server(const string &socket_path) {
+    struct sockaddr_un address;
+    int fd = -1;
+
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    if (connect(fd, (struct sockaddr*) &address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
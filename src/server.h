@@ -0,0 +1,134 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef SERVER_H_
+#define SERVER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parameters.h"
+#include "threadpool.h"
+#include "video.h"
+#include "visualrhythm.h"
+
+// Class liable for serving extraction requests received through a Unix socket. Each request is
+// a line with the same options of the command line, and the reply is a line with the output
+// location ("OK <output_image> <milliseconds>") or an error ("ERROR <message>"). Every worker
+// keeps its own Video and VisualRhythm objects, so their buffers stay allocated between requests.
+class Server {
+
+private:
+
+    // Path of the Unix socket
+    string socket_path;
+
+    // Number of workers processing requests at the same time
+    int worker_number;
+
+    // Number of threads used to compute each frame, shared by all workers
+    int thread_number;
+
+    // Pool of threads shared by all workers
+    ThreadPool thread_pool;
+
+    // Listening socket descriptor
+    int listen_fd;
+
+    // To stop the server
+    bool stop;
+
+    // Accepted connections waiting for a worker
+    queue<int> pending_connections;
+
+    // Connections being served by the workers, shut down when the server stops
+    set<int> open_connections;
+
+    // Mutex protecting the pending and open connections and the stop flag
+    std::mutex mutex;
+
+    // Condition used to wake up the workers
+    std::condition_variable condition;
+
+    // Threads of the workers
+    vector<std::thread> workers;
+
+    // To serve the connections until the server stops
+    void worker_loop();
+
+    // To serve all requests of a connection
+    void handle_connection(int fd, Video &processor, VisualRhythm &visual_rhythm);
+
+    // To process a single request and build its reply
+    string handle_request(const string &request, Video &processor, VisualRhythm &visual_rhythm);
+
+    // To stop the server
+    void stop_it();
+
+    // Is the server stopped?
+    bool is_stopped();
+
+public:
+
+    // Constructor
+    Server();
+
+    // Destructor
+    ~Server();
+
+    // To set the path of the Unix socket
+    void set_socket_path(string socket_path);
+
+    // To set the number of workers
+    void set_worker_number(int worker_number);
+
+    // To set the number of threads used to compute each frame
+    void set_thread_number(int thread_number);
+
+    // To listen the socket and serve the requests until a SHUTDOWN request is received
+    bool run();
+
+};
+
+// To read a line from a socket, buffer keeps the bytes received after the line
+bool read_line(int fd, string &buffer, string &line);
+
+// To write a line into a socket
+bool write_line(int fd, const string &line);
+
+// To connect to a server listening on a Unix socket, returns -1 on failure
+int connect_server(const string &socket_path);
+
+#endif /* SERVER_H_ */
@@ -0,0 +1,129 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef SPSCQUEUE_H_
+#define SPSCQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Class liable for a bounded lock-free queue with one producer thread and one consumer thread.
+// push waits while the queue is full, so a slow consumer holds back its producer.
+template<typename T>
+class SpscQueue {
+
+private:
+
+    // Items of the queue, the capacity is a power of two
+    vector<T> items;
+
+    // Mask used to wrap the positions into the items
+    size_t mask;
+
+    // Keeps the positions on different cache lines, so the two threads do not share one
+    char padding_head[64];
+
+    // Position of the next item to be popped (written only by the consumer)
+    std::atomic<size_t> head;
+
+    char padding_tail[64];
+
+    // Position of the next item to be pushed (written only by the producer)
+    std::atomic<size_t> tail;
+
+public:
+
+    // Constructor, the capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 1;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        this->items.resize(size);
+        this->mask = size - 1;
+        this->head = 0;
+        this->tail = 0;
+    }
+
+    // To push an item, returns false if the queue is full
+    bool try_push(const T &item) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+
+        if (tail - this->head.load(std::memory_order_acquire) > this->mask) {
+            return false;
+        }
+
+        this->items[tail & this->mask] = item;
+        this->tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // To pop an item, returns false if the queue is empty
+    bool try_pop(T &item) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+
+        if (head == this->tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = this->items[head & this->mask];
+        this->head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // To push an item, waiting while the queue is full
+    void push(const T &item) {
+        while (!try_push(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // To pop an item, waiting while the queue is empty
+    T pop() {
+        T item;
+
+        while (!try_pop(item)) {
+            std::this_thread::yield();
+        }
+
+        return item;
+    }
+
+};
+
+#endif /* SPSCQUEUE_H_ */
@@ -0,0 +1,169 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "threadpool.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+// State shared by the chunks of one parallel_for call
+struct ParallelJob {
+    std::function<void(int)> body;
+    int chunks;
+    std::atomic<int> next_chunk;
+    std::atomic<int> finished_chunks;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+// To run chunks of a job until all of them were taken
+static void run_chunks(ParallelJob &job) {
+    int chunk = 0;
+
+    while ((chunk = job.next_chunk.fetch_add(1)) < job.chunks) {
+        {
+            TraceScope trace("ThreadPool::chunk");
+            job.body(chunk);
+        }
+
+        if (job.finished_chunks.fetch_add(1) + 1 == job.chunks) {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.condition.notify_all();
+        }
+    }
+}
+
+ThreadPool::ThreadPool() {
+    this->stop = false;
+}
+
+ThreadPool::~ThreadPool() {
+    stop_all();
+}
+
+void ThreadPool::start(int thread_number) {
+    stop_all();
+
+    this->stop = false;
+
+    for (int i = 1; i < thread_number; i++) {
+        this->workers.push_back(std::thread(&ThreadPool::worker_loop, this));
+    }
+}
+
+void ThreadPool::stop_all() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stop = true;
+    }
+
+    this->condition.notify_all();
+
+    for (size_t i = 0; i < this->workers.size(); i++) {
+        this->workers[i].join();
+    }
+
+    this->workers.clear();
+}
+
+int ThreadPool::get_thread_number() const {
+    return static_cast<int>(this->workers.size()) + 1;
+}
+
+void ThreadPool::parallel_for(int chunks, const std::function<void(int)> &body) {
+
+    if (chunks <= 0) {
+        return;
+    }
+
+    if (chunks == 1 || this->workers.empty()) {
+        for (int chunk = 0; chunk < chunks; chunk++) {
+            body(chunk);
+        }
+        return;
+    }
+
+    std::shared_ptr<ParallelJob> job = std::make_shared<ParallelJob>();
+    job->body = body;
+    job->chunks = chunks;
+    job->next_chunk = 0;
+    job->finished_chunks = 0;
+
+    int helpers = std::min(chunks - 1, static_cast<int>(this->workers.size()));
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        for (int i = 0; i < helpers; i++) {
+            this->tasks.push_back([job]() { run_chunks(*job); });
+        }
+    }
+
+    this->condition.notify_all();
+
+    run_chunks(*job);
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    while (job->finished_chunks.load() < job->chunks) {
+        job->condition.wait(lock);
+    }
+}
+
+void ThreadPool::worker_loop() {
+
+    set_trace_thread_name("Pool worker");
+
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            while (!this->stop && this->tasks.empty()) {
+                this->condition.wait(lock);
+            }
+
+            if (this->stop && this->tasks.empty()) {
+                return;
+            }
+
+            task = this->tasks.front();
+            this->tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+void chunk_range(int n, int chunks, int chunk, int &begin, int &end) {
+    begin = static_cast<int>((static_cast<long>(n) * chunk) / chunks);
+    end = static_cast<int>((static_cast<long>(n) * (chunk + 1)) / chunks);
+}
@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Class liable for a pool of threads shared by the parallel parts of the computation. The thread
+// calling parallel_for also runs chunks, so parallel_for may be called from several threads (or
+// from inside a chunk) without waiting for a free worker.
+class ThreadPool {
+
+private:
+
+    // Threads of the pool
+    vector<std::thread> workers;
+
+    // Tasks waiting for a worker
+    deque< std::function<void()> > tasks;
+
+    // Mutex protecting the tasks and the stop flag
+    std::mutex mutex;
+
+    // Condition used to wake up the workers
+    std::condition_variable condition;
+
+    // To stop the workers
+    bool stop;
+
+    // To run the tasks until the pool is stopped
+    void worker_loop();
+
+public:
+
+    // Constructor
+    ThreadPool();
+
+    // Destructor
+    ~ThreadPool();
+
+    // To start the workers, the calling thread of parallel_for is counted as one of the threads
+    void start(int thread_number);
+
+    // To stop the workers
+    void stop_all();
+
+    // To get the number of threads used by parallel_for (workers plus the calling thread)
+    int get_thread_number() const;
+
+    // To run body(chunk) for every chunk in [0, chunks), returns when all chunks are finished
+    void parallel_for(int chunks, const std::function<void(int)> &body);
+
+};
+
+// To split [0, n) in chunks of almost the same size and get the range of one chunk
+void chunk_range(int n, int chunks, int chunk, int &begin, int &end);
+
+#endif /* THREADPOOL_H_ */
@@ -0,0 +1,219 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#include "tracer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+
+// Largest number of events kept by each thread, the next ones are counted but dropped
+#define MAX_TRACE_EVENTS (1 << 20)
+
+// Event of the trace
+struct TraceEvent {
+    const char *name;
+    long long begin;
+    long long end;
+};
+
+// Events recorded by one thread
+struct ThreadTrace {
+    int id;
+    string name;
+    vector<TraceEvent> events;
+    long dropped;
+};
+
+std::atomic<bool> trace_enabled(false);
+
+// Buffers of all threads, kept after their threads exit
+static std::mutex trace_mutex;
+static vector< std::unique_ptr<ThreadTrace> > thread_traces;
+static string trace_filename = "";
+static std::chrono::steady_clock::time_point trace_start;
+
+// Buffer of the calling thread, registered at its first event
+static thread_local ThreadTrace *thread_trace = NULL;
+
+static ThreadTrace* get_thread_trace() {
+
+    if (thread_trace == NULL) {
+        std::lock_guard<std::mutex> lock(trace_mutex);
+        std::unique_ptr<ThreadTrace> trace(new ThreadTrace());
+
+        trace->id = static_cast<int>(thread_traces.size()) + 1;
+        trace->name = "";
+        trace->dropped = 0;
+        trace->events.reserve(4096);
+
+        thread_trace = trace.get();
+        thread_traces.push_back(std::move(trace));
+    }
+
+    return thread_trace;
+}
+
+static void write_trace_at_exit() {
+    write_trace();
+}
+
+// To write a string as a JSON string
+static void write_json_string(FILE *file, const string &text) {
+    fputc('"', file);
+
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+            fputc(c, file);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            fprintf(file, "\\u%04x", c);
+        } else {
+            fputc(c, file);
+        }
+    }
+
+    fputc('"', file);
+}
+
+void start_tracing(const string &filename) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+
+    if (!trace_filename.empty()) {
+        trace_filename = filename;
+        return;
+    }
+
+    trace_filename = filename;
+    trace_start = std::chrono::steady_clock::now();
+    trace_enabled = true;
+
+    std::atexit(write_trace_at_exit);
+}
+
+long long get_trace_time() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - trace_start).count();
+}
+
+void set_trace_thread_name(const string &name) {
+
+    if (!trace_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    ThreadTrace *trace = get_thread_trace();
+    std::lock_guard<std::mutex> lock(trace_mutex);
+
+    trace->name = name;
+}
+
+void add_trace_event(const char *name, long long begin, long long end) {
+    ThreadTrace *trace = get_thread_trace();
+
+    if (trace->events.size() >= MAX_TRACE_EVENTS) {
+        trace->dropped++;
+        return;
+    }
+
+    TraceEvent event = { name, begin, end };
+    trace->events.push_back(event);
+}
+
+bool write_trace() {
+
+    if (!trace_enabled.load()) {
+        return true;
+    }
+
+    // The threads still running stop recording before their buffers are read
+    trace_enabled = false;
+
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    FILE *file = fopen(trace_filename.c_str(), "w");
+    int pid = static_cast<int>(getpid());
+    long dropped = 0;
+    bool is_first = true;
+
+    if (file == NULL) {
+        cout << "Error:write_trace():Could not write " << trace_filename << endl;
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (size_t t = 0; t < thread_traces.size(); t++) {
+        const ThreadTrace &trace = *thread_traces[t];
+
+        if (!trace.name.empty()) {
+            fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,",
+              is_first ? "" : ",\n", pid, trace.id);
+            fprintf(file, "\"args\":{\"name\":");
+            write_json_string(file, trace.name);
+            fprintf(file, "}}");
+            is_first = false;
+        }
+
+        // Complete events, with the times in microseconds
+        for (size_t i = 0; i < trace.events.size(); i++) {
+            const TraceEvent &event = trace.events[i];
+
+            fprintf(file, "%s{\"ph\":\"X\",\"name\":", is_first ? "" : ",\n");
+            write_json_string(file, event.name);
+            fprintf(file, ",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", pid, trace.id,
+              event.begin / 1000.0, (event.end - event.begin) / 1000.0);
+            is_first = false;
+        }
+
+        dropped += trace.dropped;
+    }
+
+    fprintf(file, "\n]}\n");
+
+    bool is_written = (fclose(file) == 0);
+
+    if (dropped > 0) {
+        cout << "Warning:write_trace():" << dropped << " events were dropped" << endl;
+    }
+
+    if (!is_written) {
+        cout << "Error:write_trace():Could not write " << trace_filename << endl;
+    }
+
+    return is_written;
+}
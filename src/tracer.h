@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+#ifndef TRACER_H_
+#define TRACER_H_
+
+#include <atomic>
+#include <string>
+
+using namespace std;
+
+// Is the trace being recorded? (read by every TraceScope, so it is kept out of the functions)
+extern std::atomic<bool> trace_enabled;
+
+// To start recording the trace events, which are written to the file at the exit of the program
+// in the trace-event JSON format of Chrome (chrome://tracing) and Perfetto (ui.perfetto.dev)
+void start_tracing(const string &filename);
+
+// To write the events recorded so far, returns false if the file could not be written
+bool write_trace();
+
+// To name the calling thread in the trace
+void set_trace_thread_name(const string &name);
+
+// To get the time of the trace, in nanoseconds since the trace was started
+long long get_trace_time();
+
+// To record an event of the calling thread (name must be a string literal)
+void add_trace_event(const char *name, long long begin, long long end);
+
+// Class liable for recording the execution of a scope as an event of the calling thread. Each
+// thread appends its events to its own buffer, without locks. When the trace is not being
+// recorded, it costs one atomic load.
+class TraceScope {
+
+private:
+
+    // Name of the event
+    const char *name;
+
+    // Time at the beginning of the scope (negative when not tracing)
+    long long begin;
+
+public:
+
+    // Constructor
+    explicit TraceScope(const char *name) {
+        this->name = name;
+        this->begin = trace_enabled.load(std::memory_order_relaxed) ? get_trace_time() : -1;
+    }
+
+    // Destructor
+    ~TraceScope() {
+        if (this->begin >= 0) {
+            add_trace_event(this->name, this->begin, get_trace_time());
+        }
+    }
+
+};
+
+#endif /* TRACER_H_ */
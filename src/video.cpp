@@ -16,6 +16,7 @@
 \*------------------------------------------------------------------------------------------------*/
 
 #include "video.h"
+#include "tracer.h"
 using namespace std;
 using namespace cv;
 
@@ -25,6 +26,10 @@ Video::Video() {
     this->delay = -1;
     this->frame_to_stop = -1;
     this->frame_processor = NULL;
+    this->pipelined = false;
+    this->is_raw = false;
+    this->triage_index = 0;
+    this->is_keyframe_triage = false;
     this->window_name_input = "";
     this->window_name_output = "";
 }
@@ -33,9 +38,28 @@ Video::~Video() {}
 
 bool Video::set_input_video(string filename) {
     input_video.release();
+    raw_video.release();
+    triage_frames.clear();
+
+    input_filename = filename;
+    is_raw = RawVideo::is_raw_video(filename);
+
+    if (is_raw)
+        return raw_video.open(filename);
+
     return input_video.open(filename);
 }
 
+bool Video::set_input_frames(const vector<Mat> &frames, double frame_rate) {
+    input_video.release();
+    triage_frames.clear();
+    input_filename.clear();
+
+    is_raw = true;
+
+    return raw_video.open_frames(frames, frame_rate);
+}
+
 bool Video::set_output_video(const std::string &output_filename, int codec=0, double frame_rate=0.0,
   bool is_color=false) {
 
@@ -61,15 +85,61 @@ void Video::set_frame_to_stop(long frame_to_stop) {
     this->frame_to_stop = frame_to_stop;
 }
 
+void Video::set_pipelined(bool pipelined) {
+    this->pipelined = pipelined;
+}
+
+long Video::set_triage(long frame_number) {
+
+    vector<long> keyframes;
+
+    triage_frames.clear();
+    triage_index = 0;
+
+    // Pre-decoded videos and videos without an index are read at evenly spaced frames
+    is_keyframe_triage = !is_raw && read_keyframes(input_filename, keyframes);
+
+    if (!is_keyframe_triage) {
+        for (long f = 0; f < get_total_frame_count(); f += TRIAGE_FRAME_GAP) {
+            keyframes.push_back(f);
+        }
+    }
+
+    // Codecs coding every frame as a keyframe would make the triage read every frame
+    for (size_t i = 0; i < keyframes.size(); i++) {
+        if ((long)triage_frames.size() >= frame_number)
+            break;
+
+        if (triage_frames.empty() || keyframes[i] - triage_frames.back() >= TRIAGE_FRAME_GAP)
+            triage_frames.push_back(keyframes[i]);
+    }
+
+    return triage_frames.size();
+}
+
+bool Video::is_keyframe_index() const {
+    return is_keyframe_triage;
+}
+
+long Video::get_triage_frame_number() const {
+    return triage_frames.size();
+}
+
 void Video::set_delay(int delay) {
     this->delay = delay;
 }
 
 bool Video::set_position_frame_number(long frame_number) {
+    if (is_raw)
+        return raw_video.set_position_frame_number(frame_number);
+
     return input_video.set(CV_CAP_PROP_POS_FRAMES, frame_number);
 }
 
 bool Video::set_position_millisecond(double ms) {
+    if (is_raw)
+        return raw_video.set_position_frame_number(static_cast<long>(ms * get_frame_rate() / 1000.0));
+
     return input_video.set(CV_CAP_PROP_POS_MSEC, ms);
 }
 
@@ -78,19 +148,31 @@ long Video::get_frame_to_stop() const {
 }
 
 long Video::get_position_frame_number() {
+    if (is_raw)
+        return raw_video.get_position_frame_number();
+
     return input_video.get(CV_CAP_PROP_POS_FRAMES);
 }
 
 long Video::get_position_millisecond() {
+    if (is_raw)
+        return static_cast<long>(raw_video.get_position_frame_number() * 1000.0 / get_frame_rate());
+
     return input_video.get(CV_CAP_PROP_POS_MSEC);
 }
 
 double Video::get_frame_rate() {
+    if (is_raw)
+        return raw_video.get_frame_rate();
+
     return input_video.get(CV_CAP_PROP_FPS);
 }
 
 Size Video::get_frame_size() {
 
+    if (is_raw)
+        return Size(raw_video.get_frame_width(), raw_video.get_frame_height());
+
     int width = static_cast<int>(this->input_video.get(CV_CAP_PROP_FRAME_WIDTH));
     int height = static_cast<int>(this->input_video.get(CV_CAP_PROP_FRAME_HEIGHT));
 
@@ -98,18 +180,30 @@ Size Video::get_frame_size() {
 }
 
 int Video::get_frame_height() {
+    if (is_raw)
+        return raw_video.get_frame_height();
+
     return input_video.get(CV_CAP_PROP_FRAME_HEIGHT);
 }
 
 int Video::get_frame_width() {
+    if (is_raw)
+        return raw_video.get_frame_width();
+
     return input_video.get(CV_CAP_PROP_FRAME_WIDTH);
 }
 
 long Video::get_total_frame_count() {
+    if (is_raw)
+        return raw_video.get_total_frame_count();
+
     return input_video.get(CV_CAP_PROP_FRAME_COUNT);
 }
 
 int Video::get_codec() {
+    if (is_raw)
+        return 0;
+
     return static_cast<int>(input_video.get(CV_CAP_PROP_FOURCC));
 }
 
@@ -141,6 +235,13 @@ void Video::run() {
     if (!is_opened())
         return;
 
+    // The frames are only displayed from the calling thread, one at a time
+    if (pipelined && frame_processor->get_stage_number() > 1 && delay < 0 &&
+      window_name_input.length() == 0 && window_name_output.length() == 0) {
+        run_pipelined();
+        return;
+    }
+
     stop = false;
 
     while (!is_stopped()) {
@@ -153,6 +254,9 @@ void Video::run() {
 
         frame_processor->process(frame, output);
 
+        if (frame_processor->is_done())
+            stop_it();
+
         if (output_filename.length() != 0)
             write_next_frame(output);
 
@@ -165,6 +269,100 @@ void Video::run() {
         if (frame_to_stop >= 0 && get_position_frame_number() == frame_to_stop)
             stop_it();
     }
+
+    frame_processor->finish();
+}
+
+void Video::run_pipelined() {
+
+    int stage_number = frame_processor->get_stage_number();
+
+    // Each frame in flight owns the buffers of its stages: frames[i][s] is the input of stage s
+    vector< vector<Mat> > frames(PIPELINE_FRAME_NUMBER, vector<Mat>(stage_number + 1));
+
+    // queues[s] feeds stage s, and queues[stage_number] returns the free frames to the reader
+    vector< SpscQueue<int>* > queues;
+    for (int s = 0; s <= stage_number; s++) {
+        queues.push_back(new SpscQueue<int>(PIPELINE_FRAME_NUMBER));
+    }
+
+    for (int i = 0; i < PIPELINE_FRAME_NUMBER; i++) {
+        queues[stage_number]->push(i);
+    }
+
+    vector<std::thread> stages;
+    for (int s = 0; s < stage_number; s++) {
+        stages.push_back(std::thread(&Video::run_stage, this, s, std::ref(frames),
+          std::ref(*queues[s]), std::ref(*queues[s + 1])));
+    }
+
+    stop = false;
+
+    while (!is_stopped()) {
+
+        int i = 0;
+
+        {
+            TraceScope trace("Video::wait_free_frame");
+            i = queues[stage_number]->pop();
+        }
+
+        if (!read_next_frame(frames[i][0]))
+            break;
+
+        queues[0]->push(i);
+
+        // The frames already in flight are processed, the next ones are not decoded
+        if (frame_processor->is_done())
+            stop_it();
+
+        if (frame_to_stop >= 0 && get_position_frame_number() == frame_to_stop)
+            stop_it();
+    }
+
+    // A negative frame index tells the stages that the video is over
+    queues[0]->push(-1);
+
+    for (size_t s = 0; s < stages.size(); s++) {
+        stages[s].join();
+    }
+
+    for (size_t s = 0; s < queues.size(); s++) {
+        delete queues[s];
+    }
+
+    frame_processor->finish();
+}
+
+void Video::run_stage(int stage, vector< vector<Mat> > &frames, SpscQueue<int> &input,
+  SpscQueue<int> &output) {
+
+    bool is_last_stage = (stage + 1 == frame_processor->get_stage_number());
+
+    set_trace_thread_name("Stage " + std::to_string(stage));
+
+    while (true) {
+
+        int i = 0;
+
+        {
+            TraceScope trace("Video::wait_input");
+            i = input.pop();
+        }
+
+        if (i < 0) {
+            if (!is_last_stage)
+                output.push(i);
+            break;
+        }
+
+        frame_processor->process_stage(stage, frames[i][stage], frames[i][stage + 1]);
+
+        if (is_last_stage && output_filename.length() != 0)
+            write_next_frame(frames[i][stage + 1]);
+
+        output.push(i);
+    }
 }
 
 void Video::stop_it() {
@@ -176,13 +374,29 @@ bool Video::is_stopped() const {
 }
 
 bool Video::is_opened() {
+    if (is_raw)
+        return raw_video.is_opened();
+
     return input_video.isOpened();
 }
 
 bool Video::read_next_frame(cv::Mat& frame) {
+    TraceScope trace("Video::read_next_frame");
+
+    // The triage seeks to its next keyframe, which is decoded without the frames before it
+    if (!triage_frames.empty()) {
+        if (triage_index >= triage_frames.size() ||
+          !set_position_frame_number(triage_frames[triage_index++]))
+            return false;
+    }
+
+    if (is_raw)
+        return raw_video.read(frame);
+
     return input_video.read(frame);
 }
 
 void Video::write_next_frame(cv::Mat& frame) {
+    TraceScope trace("Video::write_next_frame");
     output_video.write(frame);
 }
@@ -43,10 +43,29 @@
 // Interface whose one method is used as callback function for process the frames
 #include "frameprocessor.h"
 
+// Reader of pre-decoded videos mapped in memory
+#include "rawvideo.h"
+
+// Bounded lock-free queue connecting the stages of a pipelined processing
+#include "spscqueue.h"
+
+// Reader of the keyframe indices stored in the index of the container
+#include "keyframes.h"
+
+// To run the stages of a pipelined processing on their own threads
+#include <thread>
+
 #define SUPPORTED_CV_MAJOR_VERSION 2
 #define SUPPORTED_CV_MINOR_VERSION 4
 #define SUPPORTED_CV_SUBMINOR_VERSION 8
 
+// Number of frames in flight when the stages of the processing are pipelined
+#define PIPELINE_FRAME_NUMBER 8
+
+// Minimum distance between the frames read by the triage, and distance between them when the
+// container has no keyframe index
+#define TRIAGE_FRAME_GAP 12
+
 
 using namespace std;
 using namespace cv;
@@ -63,6 +82,12 @@ private:
     // The OpenCV video writer object
     cv::VideoWriter output_video;
 
+    // The reader of pre-decoded videos, used instead of the video capture for .y4m and .yuv files
+    RawVideo raw_video;
+
+    // Is the input a pre-decoded video?
+    bool is_raw;
+
     // The pointer to the class implementing the FrameProcessor interface
     FrameProcessor *frame_processor;
 
@@ -84,6 +109,21 @@ private:
     // Output filename
     std::string output_filename;
 
+    // To run each stage of the frame processor on its own thread
+    bool pipelined;
+
+    // Input filename
+    std::string input_filename;
+
+    // Frames read by the triage, empty when every frame is read
+    vector<long> triage_frames;
+
+    // Next frame of the triage to be read
+    size_t triage_index;
+
+    // Are the frames of the triage the keyframes of the container?
+    bool is_keyframe_triage;
+
     // To stop the processing
     void stop_it();
 
@@ -99,6 +139,13 @@ private:
     // To write the output frame into output video
     void write_next_frame(Mat &frame);
 
+    // To grab the frames on the calling thread and process each stage on its own thread
+    void run_pipelined();
+
+    // To run one stage of the pipelined processing until the end of the video
+    void run_stage(int stage, vector< vector<Mat> > &frames, SpscQueue<int> &input,
+      SpscQueue<int> &output);
+
 public:
 
     // Constructor
@@ -110,6 +157,9 @@ public:
     // To set the name of the video file
     bool set_input_video(string filename);
 
+    // To read frames already in memory (gray or BGR) instead of a video file, without copies
+    bool set_input_frames(const vector<Mat> &frames, double frame_rate);
+
     // To set the output video file by default the same parameters than input video will be used
     bool set_output_video(const std::string &output_filename, int codec, double frame_rate,
       bool is_color);
@@ -120,6 +170,19 @@ public:
     // To set the last frame number to be processed
     void set_frame_to_stop(long frame_to_stop);
 
+    // To set whether the stages of the frame processor run on their own threads
+    void set_pipelined(bool pipelined);
+
+    // To read only the keyframes of the video, at most frame_number of them and at least
+    // TRIAGE_FRAME_GAP frames apart. Returns the number of frames that will be read
+    long set_triage(long frame_number);
+
+    // Are the frames of the triage the keyframes of the container, instead of evenly spaced frames?
+    bool is_keyframe_index() const;
+
+    // To get the number of frames read by the triage
+    long get_triage_frame_number() const;
+
     // To set a delay between each frame
     // 0 means wait at each frame and negative means no delay
     void set_delay(int delay);
@@ -29,11 +29,46 @@
 \*------------------------------------------------------------------------------------------------*/
 
 #include "visualrhythm.h"
+#include "checksum.h"
+#include "fastspectrum.h"
+#include "kernels.h"
+#include "tracer.h"
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <cstring>
 using namespace cv;
 using namespace std;
 
+// Rows and frames of each block of the transpose from strips to image, small enough for the rows
+// of both to stay in the cache
+#define ASSEMBLY_BLOCK_ROWS 64
+#define ASSEMBLY_BLOCK_FRAMES 16
+
+// Rows of the noise image transformed together with -row_fusion: for 1920-pixel rows, the noise,
+// the filtered rows with their halo and the rows of the transform of a block take less than 1 MB
+#define FUSION_BLOCK_ROWS 32
+
+// Copies the strips of frames [first, last), one per row of strips, to their columns of the image
+static void assemble_strips(const Mat &strips, int first, int last, int width, Mat &image) {
+
+    for (int y0 = 0; y0 < image.rows; y0 += ASSEMBLY_BLOCK_ROWS) {
+        int y1 = std::min(y0 + ASSEMBLY_BLOCK_ROWS, image.rows);
+
+        for (int f0 = first; f0 < last; f0 += ASSEMBLY_BLOCK_FRAMES) {
+            int f1 = std::min(f0 + ASSEMBLY_BLOCK_FRAMES, last);
+
+            for (int y = y0; y < y1; y++) {
+                uchar *dst = image.ptr<uchar>(y);
+
+                for (int f = f0; f < f1; f++) {
+                    memcpy(dst + f * width, strips.ptr<uchar>(f) + y * width, width);
+                }
+            }
+        }
+    }
+}
+
 VisualRhythm::VisualRhythm() {
     this->visual_rhythm_type = 0;
     this->current_frame = 0;
@@ -43,24 +78,135 @@ VisualRhythm::VisualRhythm() {
     this->variance = 2.0;
     this->height = 1;
     this->width = 30;
+    this->fast_spectrum = false;
+    this->row_fusion = false;
+    this->thread_pool = NULL;
+    this->process_frame = NULL;
+    this->score_model = "";
+    this->score_interval = 15;
+    this->accept_threshold = 1.0f;
+    this->reject_threshold = -1.0f;
+    this->score = 0.0f;
+    this->decision_frame = 0;
+    this->spectrum_number = 0;
+    this->window_length = 0;
+    this->window_stride = 0;
+    this->max_windows = 0;
+    this->saved_window_number = 0;
+    this->spectrum_batch = 1;
+    this->assembled_frame_number = 0;
+    this->is_write_failed = false;
+    this->skip_duplicates = false;
+    this->last_fingerprint = 0;
+    this->has_fingerprint = false;
+    this->duplicate_frame_number = 0;
 }
 
 VisualRhythm::~VisualRhythm() {}
 
 void VisualRhythm::set_visual_rhythm(Mat ritmoVisual) {
     this->visual_rhythm = ritmoVisual;
+
+    // The strips are taken from the columns of the image, which is kept up to date
+    int frames = ritmoVisual.cols / this->width;
+
+    this->strips.create(frames, ritmoVisual.rows * this->width, CV_8U);
+
+    for (int f = 0; f < frames; f++) {
+        uchar *dst = this->strips.ptr<uchar>(f);
+
+        for (int y = 0; y < ritmoVisual.rows; y++) {
+            memcpy(dst + y * this->width, ritmoVisual.ptr<uchar>(y) + f * this->width, this->width);
+        }
+    }
+
+    this->assembled_frame_number = frames;
+}
+
+Mat VisualRhythm::get_visual_rhythm() {
+    assemble_visual_rhythm(this->current_frame);
+    return this->visual_rhythm;
+}
+
+bool VisualRhythm::is_strips_full() const {
+
+    // The windows, the streamed strips and the row statistics do not use the strips
+    if (this->window_length > 0 || this->rhythm_writer.is_opened() ||
+          this->row_statistics.is_opened()) {
+        return false;
+    }
+
+    return this->current_frame >= this->strips.rows;
+}
+
+Mat VisualRhythm::get_strips() const {
+    return this->strips;
+}
+
+void VisualRhythm::assemble_visual_rhythm(int frame_number) {
+    TraceScope trace("VisualRhythm::assemble_visual_rhythm");
+    frame_number = std::min(frame_number, this->strips.rows);
+
+    if (frame_number > this->assembled_frame_number) {
+        assemble_strips(this->strips, this->assembled_frame_number, frame_number, this->width,
+          this->visual_rhythm);
+        this->assembled_frame_number = frame_number;
+    }
+}
+
+int VisualRhythm::get_frame_number() const {
+    return this->current_frame;
+}
+
+void VisualRhythm::create_visual_rhythm(int rows, int cols) {
+    this->visual_rhythm.create(rows, cols, CV_8U);
+    this->strips.create(cols / this->width, rows * this->width, CV_8U);
+    this->assembled_frame_number = 0;
+}
+
+void VisualRhythm::reset() {
+    this->current_frame = 0;
+    this->process_frame = NULL;
+    this->score = 0.0f;
+
+    // The image may be a view of the frames of the last video, which must not be written
+    this->image.release();
+
+    // The spectra of the last video may still be used by the caller
+    this->spectra.release();
+    this->decision_frame = 0;
+    this->assembled_frame_number = 0;
+    this->rhythm_writer.close();
+    this->row_statistics.close();
+    this->is_write_failed = false;
+
+    // The windows not completed by the last video are dropped
+    for (map<int, Mat>::iterator it = this->windows.begin(); it != this->windows.end(); ++it) {
+        this->free_windows.push_back(it->second);
+    }
+
+    this->windows.clear();
+    this->saved_window_number = 0;
+    this->batch_spectrum.clear();
+    this->batch_duplicates.clear();
+    this->has_fingerprint = false;
+    this->last_strip.release();
+    this->duplicate_frame_number = 0;
 }
 
 void VisualRhythm::set_visual_rhythm_type(int visual_rhythm_type) {
     this->visual_rhythm_type = visual_rhythm_type;
+    this->process_frame = NULL;
 }
 
 void VisualRhythm::set_color_space(int color_space) {
     this->color_space = color_space;
+    this->process_frame = NULL;
 }
 
 void VisualRhythm::set_filter(int filter) {
     this->filter = filter;
+    this->process_frame = NULL;
 }
 
 void VisualRhythm::set_kernel_size(int kernel_size) {
@@ -71,12 +217,213 @@ void VisualRhythm::set_variance(float variance) {
     this->variance = variance;
 }
 
+void VisualRhythm::set_fast_spectrum(bool fast_spectrum) {
+    this->fast_spectrum = fast_spectrum;
+}
+
+void VisualRhythm::set_skip_duplicates(bool skip_duplicates) {
+    this->skip_duplicates = skip_duplicates;
+}
+
+int VisualRhythm::get_duplicate_frame_number() const {
+    return this->duplicate_frame_number;
+}
+
+void VisualRhythm::set_row_fusion(bool row_fusion) {
+    this->row_fusion = row_fusion;
+}
+
+void VisualRhythm::set_spectrum_batch(int spectrum_batch) {
+    this->spectrum_batch = std::max(1, std::min(spectrum_batch, MAX_SPECTRUM_BATCH));
+
+    if (this->batch_spectrum.get_batch_size() != this->spectrum_batch) {
+        this->batch_spectrum.set_batch_size(this->spectrum_batch);
+    }
+}
+
+void VisualRhythm::set_thread_pool(ThreadPool *thread_pool) {
+    this->thread_pool = thread_pool;
+}
+
+bool VisualRhythm::set_score_model(const string &score_model) {
+
+    if (score_model.empty()) {
+        this->score_model = "";
+        return true;
+    }
+
+    if (score_model.compare(this->score_model) != 0) {
+        if (!this->scorer.load(score_model)) {
+            this->score_model = "";
+            return false;
+        }
+        this->score_model = score_model;
+    }
+
+    return true;
+}
+
+void VisualRhythm::set_score_interval(int score_interval) {
+    this->score_interval = score_interval;
+}
+
+void VisualRhythm::set_score_thresholds(float reject_threshold, float accept_threshold) {
+    this->reject_threshold = reject_threshold;
+    this->accept_threshold = accept_threshold;
+}
+
+bool VisualRhythm::is_done() {
+    return this->decision_frame.load() > 0;
+}
+
+float VisualRhythm::get_score() const {
+    return this->score;
+}
+
+int VisualRhythm::get_decision() const {
+
+    if (this->decision_frame.load() == 0) {
+        return 0;
+    }
+
+    return (this->score >= this->accept_threshold) ? 1 : -1;
+}
+
+int VisualRhythm::get_decision_frame() const {
+    return this->decision_frame.load();
+}
+
+void VisualRhythm::set_spectrum_number(int spectrum_number) {
+    this->spectrum_number = spectrum_number;
+    this->spectra.release();
+}
+
+Mat VisualRhythm::get_spectra() const {
+
+    if (this->spectra.empty()) {
+        return Mat();
+    }
+
+    int rows = this->spectra.rows / this->spectrum_number;
+
+    return this->spectra.rowRange(0, std::min(this->current_frame, this->spectrum_number) * rows);
+}
+
+void VisualRhythm::keep_spectrum(const Mat &spectrum) {
+
+    if (this->current_frame >= this->spectrum_number) {
+        return;
+    }
+
+    if (this->spectra.empty()) {
+        this->spectra.create(this->spectrum_number * spectrum.rows, spectrum.cols, CV_8U);
+    }
+
+    Mat slot = this->spectra.rowRange(this->current_frame * spectrum.rows,
+      (this->current_frame + 1) * spectrum.rows);
+
+    spectrum.copyTo(slot);
+}
+
+void VisualRhythm::set_windows(int window_length, int window_stride, int max_windows) {
+    this->window_length = window_length;
+    this->window_stride = (window_stride > 0) ? window_stride : window_length;
+    this->max_windows = max_windows;
+}
+
+int VisualRhythm::get_window_frame_number() const {
+
+    if (this->max_windows <= 0) {
+        return -1;
+    }
+
+    return (this->max_windows - 1) * this->window_stride + this->window_length;
+}
+
+int VisualRhythm::get_saved_window_number() const {
+    return this->saved_window_number;
+}
+
+string VisualRhythm::get_window_filename(int window) const {
+    char suffix[16];
+    size_t slash = this->output_filename.find_last_of('/');
+    size_t point = this->output_filename.find_last_of('.');
+
+    snprintf(suffix, sizeof(suffix), "_w%04d", window);
+
+    if (point == string::npos || (slash != string::npos && point < slash)) {
+        return this->output_filename + suffix;
+    }
+
+    return this->output_filename.substr(0, point) + suffix + this->output_filename.substr(point);
+}
+
+void VisualRhythm::place_window_strip(Mat &strip) {
+    const int frame = this->current_frame;
+    const int length = this->window_length;
+    const int stride = this->window_stride;
+
+    // Windows [first, last] cover the frame: window w covers [w * stride, w * stride + length)
+    int first = (frame < length) ? 0 : (frame - length + stride) / stride;
+    int last = frame / stride;
+
+    if (this->max_windows > 0) {
+        last = std::min(last, this->max_windows - 1);
+    }
+
+    for (int w = first; w <= last; w++) {
+        int offset = frame - w * stride;
+
+        if (offset == 0) {
+            Mat window;
+
+            if (!this->free_windows.empty()) {
+                window = this->free_windows.back();
+                this->free_windows.pop_back();
+            }
+
+            window.create(length, this->height * this->width, CV_8U);
+            this->windows[w] = window;
+        }
+
+        map<int, Mat>::iterator it = this->windows.find(w);
+
+        if (it == this->windows.end()) {
+            continue;
+        }
+
+        uchar *dst = it->second.ptr<uchar>(offset);
+
+        for (int y = 0; y < strip.rows; y++) {
+            memcpy(dst + y * this->width, strip.ptr<uchar>(y), this->width);
+        }
+
+        if (offset == length - 1) {
+            TraceScope trace("VisualRhythm::save_window");
+
+            this->window_image.create(this->height, length * this->width, CV_8U);
+            assemble_strips(it->second, 0, length, this->width, this->window_image);
+
+            if (!imwrite(get_window_filename(w).c_str(), this->window_image)) {
+                cout << "Error:VisualRhythm::place_window_strip():Could not write ";
+                cout << get_window_filename(w) << endl;
+                this->is_write_failed = true;
+            }
+
+            this->free_windows.push_back(it->second);
+            this->windows.erase(it);
+            this->saved_window_number++;
+        }
+    }
+}
+
 void VisualRhythm::set_height(int height) {
     this->height = height;
 }
 
 void VisualRhythm::set_width(int width) {
     this->width = width;
+    this->process_frame = NULL;
 }
 
 void VisualRhythm::set_output_filename(string output_filename) {
@@ -120,78 +467,443 @@ int VisualRhythm::compute_dimensions_visual_rhythm(int rows, int cols){
         return row;
 }
 
-void VisualRhythm::save_visual_rhythm() {
-    imwrite(this->output_filename.c_str(), this->visual_rhythm);
+bool VisualRhythm::open_streaming_output() {
+    return this->rhythm_writer.open(this->output_filename, this->height);
+}
+
+void VisualRhythm::open_row_statistics() {
+    this->row_statistics.open(this->height);
+}
+
+bool VisualRhythm::save_visual_rhythm() {
+    TraceScope trace("VisualRhythm::save_visual_rhythm");
+
+    // The windows are saved as they are completed
+    if (this->window_length > 0) {
+        return !this->is_write_failed;
+    }
+
+    // The header is rewritten even after a failed strip, so the file is not left without one
+    if (this->rhythm_writer.is_opened()) {
+        return this->rhythm_writer.close() && !this->is_write_failed;
+    }
+
+    if (this->row_statistics.is_opened()) {
+        return this->row_statistics.save(this->output_filename);
+    }
+
+    bool is_written = false;
+
+    // After an early decision only the strips used by the decision are saved
+    if (this->decision_frame.load() > 0) {
+        assemble_visual_rhythm(this->decision_frame.load());
+        is_written = imwrite(this->output_filename.c_str(),
+          this->visual_rhythm.colRange(0, this->decision_frame.load() * this->width));
+    } else {
+        assemble_visual_rhythm(this->strips.rows);
+        is_written = imwrite(this->output_filename.c_str(), this->visual_rhythm);
+    }
+
+    if (!is_written) {
+        cout << "Error:VisualRhythm::save_visual_rhythm():Could not write ";
+        cout << this->output_filename << endl;
+    }
+
+    return is_written;
 }
 
 void VisualRhythm::process(cv::Mat &frame, cv::Mat &output) {
-    Mat image;
-    Mat noise;
-    Mat espectrum;
-    Mat colorSpace;
-    vector<Mat> bandas;
+
+    if (this->skip_duplicates && is_duplicate_frame(frame)) {
+        place_duplicate_frame(output);
+        return;
+    }
+
+    if (this->spectrum_batch > 1) {
+        process_batched(frame, output);
+        return;
+    }
+
+    if (this->process_frame == NULL) {
+        select_pipeline();
+    }
+
+    if (this->process_frame == NULL) {
+        frame.copyTo(output);
+        cout << "Error:VisualRhythm::process():Invalid parameters" << endl;
+        return;
+    }
+
+    (this->*process_frame)(frame, output);
+}
+
+int VisualRhythm::get_stage_number() const {
+    return 4;
+}
+
+void VisualRhythm::process_stage(int stage, cv::Mat &input, cv::Mat &output) {
+
+    switch (stage) {
+        case 0:
+            convert_color_space(input, output);
+            break;
+        case 1:
+            compute_noise_image(input, output);
+            break;
+        case 2:
+            compute_fourier_spectrum(input, output);
+            break;
+        default:
+            compute_strip(input, output);
+            break;
+    }
+}
+
+void VisualRhythm::compute_strip(Mat &spectrum, Mat &strip) {
+
+    if (this->spectrum_number > 0) {
+        keep_spectrum(spectrum);
+    }
+
+    if (this->visual_rhythm_type == 0) {
+        extract_strip_specialized<0>(spectrum, strip);
+    } else if (this->visual_rhythm_type == 1) {
+        extract_strip_specialized<1>(spectrum, strip);
+    } else if (this->visual_rhythm_type == 2) {
+        extract_strip_specialized<2>(spectrum, strip);
+    } else {
+        cout << "Error:VisualRhythm::process():Invalid visual rhyhtm type" << endl;
+        return;
+    }
+
+    if (this->skip_duplicates) {
+        strip.copyTo(this->last_strip);
+    }
+
+    place_strip_specialized<0>(strip);
+    this->current_frame++;
+    check_score();
+}
+
+void VisualRhythm::process_batched(cv::Mat &frame, cv::Mat &output) {
+    convert_color_space(frame, this->image);
+    compute_noise_image(this->image, this->noise);
+
+    // A batch holds frames of one size
+    if (!this->batch_spectrum.is_compatible(this->noise)) {
+        compute_batch_strips(output);
+    }
+
+    this->batch_spectrum.add(this->noise);
+    this->batch_duplicates.push_back(0);
+
+    if (this->batch_spectrum.is_full()) {
+        compute_batch_strips(output);
+    }
+}
+
+void VisualRhythm::compute_batch_strips(cv::Mat &output) {
+    int frame_number = this->batch_spectrum.get_frame_number();
+
+    {
+        TraceScope trace("VisualRhythm::compute_batch_spectra");
+        this->batch_spectrum.transform(is_parallel() ? this->thread_pool : NULL);
+    }
+
+    for (int b = 0; b < frame_number; b++) {
+        TraceScope trace("VisualRhythm::normalize_spectrum");
+
+        if (this->fast_spectrum) {
+            float min_value = 0.0f, max_value = 0.0f;
+
+            this->batch_spectrum.get_fast_log_magnitude(b, this->magnitude_frame, min_value,
+              max_value);
+            this->spectrum.create(this->magnitude_frame.size(), CV_8U);
+            fast_normalize_shift(this->magnitude_frame, this->spectrum, min_value, max_value, 0,
+              this->magnitude_frame.rows);
+        } else {
+            this->batch_spectrum.get_log_magnitude(b, this->magnitude_frame);
+            shift_normalize_spectrum(this->magnitude_frame, this->spectrum);
+        }
+
+        compute_strip(this->spectrum, output);
+
+        for (int d = 0; d < this->batch_duplicates[b]; d++) {
+            place_duplicate_strip();
+        }
+    }
+
+    this->batch_spectrum.clear();
+    this->batch_duplicates.clear();
+}
+
+void VisualRhythm::finish() {
+
+    if (this->spectrum_batch > 1 && this->batch_spectrum.get_frame_number() > 0) {
+        Mat strip;
+        compute_batch_strips(strip);
+    }
+}
+
+bool VisualRhythm::is_duplicate_frame(const Mat &frame) {
+    TraceScope trace("VisualRhythm::fingerprint");
+
+    // The size and the type of the frame are part of the fingerprint
+    uint64_t header[3] = {static_cast<uint64_t>(frame.rows), static_cast<uint64_t>(frame.cols),
+      static_cast<uint64_t>(frame.type())};
+    size_t row_size = frame.cols * frame.elemSize();
+    Checksum fingerprint;
+
+    fingerprint.update(header, sizeof(header));
+
+    if (frame.isContinuous()) {
+        fingerprint.update(frame.data, row_size * frame.rows);
+    } else {
+        for (int y = 0; y < frame.rows; y++) {
+            fingerprint.update(frame.ptr<uchar>(y), row_size);
+        }
+    }
+
+    uint64_t digest = fingerprint.get_digest();
+    bool is_duplicate = this->has_fingerprint && digest == this->last_fingerprint;
+
+    this->last_fingerprint = digest;
+    this->has_fingerprint = true;
+
+    // A duplicate needs the strip of the previous frame, placed or waiting in the batch
+    return is_duplicate && (!this->last_strip.empty() || !this->batch_duplicates.empty());
+}
+
+void VisualRhythm::place_duplicate_frame(Mat &output) {
+
+    // The strip of the previous frame is not computed yet, it is placed again with its batch
+    if (!this->batch_duplicates.empty()) {
+        this->batch_duplicates.back()++;
+        return;
+    }
+
+    place_duplicate_strip();
+    this->last_strip.copyTo(output);
+}
+
+void VisualRhythm::place_duplicate_strip() {
+
+    // A duplicate after the last row of the strips is neither placed nor counted
+    if (is_strips_full()) {
+        return;
+    }
+
+    if (this->spectrum_number > 0) {
+        keep_spectrum(this->spectrum);
+    }
+
+    place_strip_specialized<0>(this->last_strip);
+    this->current_frame++;
+    this->duplicate_frame_number++;
+    check_score();
+}
+
+void VisualRhythm::check_score() {
+
+    // The partial visual rhythm is only in memory when it is not streamed nor summarized
+    if (this->score_model.empty() || this->rhythm_writer.is_opened() ||
+          this->row_statistics.is_opened() ||
+          this->decision_frame.load() > 0 || this->current_frame % this->score_interval != 0) {
+        return;
+    }
+
+    TraceScope trace("VisualRhythm::check_score");
+    int cols = std::min(this->current_frame * this->width, this->visual_rhythm.cols);
+
+    assemble_visual_rhythm(this->current_frame);
+
+    this->score = this->scorer.score(this->visual_rhythm.colRange(0, cols));
+
+    if (this->score >= this->accept_threshold || this->score <= this->reject_threshold) {
+        this->decision_frame = this->current_frame;
+    }
+}
+
+template<int ColorSpace, int Filter, int RhythmType, int RoiWidth>
+void VisualRhythm::process_specialized(cv::Mat &frame, cv::Mat &output) {
+    convert_color_space_specialized<ColorSpace>(frame, this->image);
+
+    // The recursive gaussian needs the whole frame before any row of the noise is known
+    if (this->row_fusion && Filter != 2) {
+        compute_fused_spectrum(this->image, this->spectrum);
+    } else {
+        compute_noise_image_specialized<Filter>(this->image, this->noise);
+        compute_fourier_spectrum(this->noise, this->spectrum);
+    }
+
+    if (this->spectrum_number > 0) {
+        keep_spectrum(this->spectrum);
+    }
+
+    extract_strip_specialized<RhythmType>(this->spectrum, output);
+
+    if (this->skip_duplicates) {
+        output.copyTo(this->last_strip);
+    }
+
+    place_strip_specialized<RoiWidth>(output);
+    this->current_frame++;
+    check_score();
+}
+
+template<int ColorSpace, int Filter, int RhythmType>
+VisualRhythm::FrameFunction VisualRhythm::select_roi_width() const {
+
+    // The most used widths have the strip copy unrolled by the compiler
+    switch (this->width) {
+        case 15:
+            return &VisualRhythm::process_specialized<ColorSpace, Filter, RhythmType, 15>;
+        case 30:
+            return &VisualRhythm::process_specialized<ColorSpace, Filter, RhythmType, 30>;
+        case 60:
+            return &VisualRhythm::process_specialized<ColorSpace, Filter, RhythmType, 60>;
+        default:
+            return &VisualRhythm::process_specialized<ColorSpace, Filter, RhythmType, 0>;
+    }
+}
+
+template<int ColorSpace, int Filter>
+VisualRhythm::FrameFunction VisualRhythm::select_rhythm_type() const {
+
+    switch (this->visual_rhythm_type) {
+        case 0:
+            return select_roi_width<ColorSpace, Filter, 0>();
+        case 1:
+            return select_roi_width<ColorSpace, Filter, 1>();
+        case 2:
+            return select_roi_width<ColorSpace, Filter, 2>();
+        default:
+            cout << "Error:VisualRhythm::process():Invalid visual rhyhtm type" << endl;
+            return NULL;
+    }
+}
+
+template<int ColorSpace>
+VisualRhythm::FrameFunction VisualRhythm::select_filter() const {
+
+    switch (this->filter) {
+        case 0:
+            return select_rhythm_type<ColorSpace, 0>();
+        case 1:
+            return select_rhythm_type<ColorSpace, 1>();
+        case 2:
+            return select_rhythm_type<ColorSpace, 2>();
+        default:
+            cout << "Error:VisualRhythm::compute_noise_image():Invalid filter type" << endl;
+            return NULL;
+    }
+}
+
+void VisualRhythm::select_pipeline() {
+
+    switch (this->color_space) {
+        case 0:
+            this->process_frame = select_filter<0>();
+            break;
+        case 1:
+            this->process_frame = select_filter<1>();
+            break;
+        default:
+            cout << "Error:VisualRhythm::convert_color_space():Invalid color space" << endl;
+            this->process_frame = NULL;
+            break;
+    }
+}
+
+template<int ColorSpace>
+void VisualRhythm::convert_color_space_specialized(Mat &frame, Mat &output) {
+    TraceScope trace("VisualRhythm::convert_color_space");
+
+    // Frames of pre-decoded videos are already luma planes, which are used without copies
+    if (ColorSpace == 0 && frame.channels() == 1) {
+
+        output = frame;
+
+    } else if (ColorSpace == 0) {
+
+        cv::cvtColor(frame, output, CV_BGR2GRAY);
+
+    } else if (frame.channels() == 1) {
+
+        cv::cvtColor(frame, this->color_frame, CV_GRAY2BGR);
+        cv::cvtColor(this->color_frame, this->color_frame, CV_BGR2Lab);
+        cv::split(this->color_frame, this->bands);
+        this->bands[0].copyTo(output);
+
+    } else {
+
+        cv::cvtColor(frame, this->color_frame, CV_BGR2Lab);
+        cv::split(this->color_frame, this->bands);
+        this->bands[0].copyTo(output);
+
+    }
+}
+
+void VisualRhythm::convert_color_space(Mat &frame, Mat &output) {
 
     if (this->color_space == 0) {
 
-        cv::cvtColor(frame, image, CV_BGR2GRAY);
+        convert_color_space_specialized<0>(frame, output);
 
     } else if (this->color_space == 1){
 
-        cv::cvtColor(frame, colorSpace, CV_BGR2Lab);
-        cv::split(colorSpace, bandas);
-        bandas[0].copyTo(image);
+        convert_color_space_specialized<1>(frame, output);
 
     } else{
 
-        cout << "Erro:VisualRhythm::process():Invalid color space" << endl;
+        cout << "Error:VisualRhythm::convert_color_space():Invalid color space" << endl;
         exit(EXIT_FAILURE);
 
     }
+}
 
-    if (this->visual_rhythm_type == 0) {
+template<int Filter>
+void VisualRhythm::compute_noise_image_specialized(Mat &image, Mat &output) {
+    TraceScope trace("VisualRhythm::compute_noise_image");
+    Mat &filtered = this->filtered;
 
-        compute_noise_image(image, noise);
-        compute_fourier_spectrum(noise, espectrum);
-        compute_vertical_visual_rhythm(espectrum, output);
-        this->current_frame++;
+    if (is_parallel()) {
 
-    } else if (this->visual_rhythm_type == 1) {
+        compute_noise_image_parallel(image, output);
 
-        compute_noise_image(image, noise);
-        compute_fourier_spectrum(noise, espectrum);
-        compute_horizontal_visual_rhythm(espectrum, output);
+    } else if (Filter == 0) {
 
-        this->current_frame++;
-    } else if (this->visual_rhythm_type == 2) {
+        cv::medianBlur(image, filtered, this->kernel_size);
+        subtract_residual(image, filtered, output);
 
-        compute_noise_image(image, noise);
-        compute_fourier_spectrum(noise, espectrum);
-        compute_zigzag_visual_rhythm(espectrum, output);
-        this->current_frame++;
+    } else if (Filter == 1) {
+
+        cv::GaussianBlur(image, filtered, cv::Size(this->kernel_size, this->kernel_size),
+          this->variance);
+        subtract_residual(image, filtered, output);
 
     } else {
 
-        frame.copyTo(output);
-        cout << "Error:VisualRhythm::process():Invalid visual rhyhtm type" << endl;
+        // The subtraction is fused with the last pass of the filter
+        this->recursive_gaussian.set_sigma(this->variance);
+        this->recursive_gaussian.compute_residual(image, output);
 
     }
-
-
 }
 
 void VisualRhythm::compute_noise_image(Mat &image, Mat &output) {
-    Mat filtered;
 
     if (this->filter == 0) {
 
-        cv::medianBlur(image, filtered, this->kernel_size);
-        cv::subtract(image, filtered, output);
+        compute_noise_image_specialized<0>(image, output);
 
     } else if (this->filter == 1) {
 
-        cv::GaussianBlur(image, filtered, cv::Size(this->kernel_size, this->kernel_size),
-          this->variance);
-        cv::subtract(image, filtered, output);
+        compute_noise_image_specialized<1>(image, output);
+
+    } else if (this->filter == 2) {
+
+        compute_noise_image_specialized<2>(image, output);
 
     } else {
 
@@ -201,8 +913,19 @@ void VisualRhythm::compute_noise_image(Mat &image, Mat &output) {
 }
 
 void VisualRhythm::compute_fourier_spectrum(Mat &frame, Mat &output) {
+    TraceScope trace("VisualRhythm::compute_fourier_spectrum");
     Mat padded;
 
+    if (is_parallel()) {
+        compute_fourier_spectrum_parallel(frame, output);
+        return;
+    }
+
+    if (this->fast_spectrum) {
+        compute_fast_fourier_spectrum(frame, output);
+        return;
+    }
+
     frame.copyTo(padded);
 
     Mat planes[] = { Mat_<float>(padded), Mat::zeros(padded.size(), CV_32F) };
@@ -220,7 +943,11 @@ void VisualRhythm::compute_fourier_spectrum(Mat &frame, Mat &output) {
     magFrame += Scalar::all(1);
     log(magFrame, magFrame);
 
-    magFrame = magFrame(Rect(0, 0, magFrame.cols & -2, magFrame.rows & -2));
+    shift_normalize_spectrum(magFrame, output);
+}
+
+void VisualRhythm::shift_normalize_spectrum(Mat &magnitude, Mat &output) {
+    Mat magFrame = magnitude(Rect(0, 0, magnitude.cols & -2, magnitude.rows & -2));
     int cx = magFrame.cols / 2;
     int cy = magFrame.rows / 2;
 
@@ -246,28 +973,391 @@ void VisualRhythm::compute_fourier_spectrum(Mat &frame, Mat &output) {
     magFrame.convertTo(output, CV_8U);
 }
 
-void VisualRhythm::compute_vertical_visual_rhythm(Mat &frame, Mat &output) {
-    Mat roi;
+bool VisualRhythm::is_parallel() const {
+    return (this->thread_pool != NULL) && (this->thread_pool->get_thread_number() > 1);
+}
 
-    roi = frame(
-            Rect((frame.cols / 2) - (this->width / 2), 0, this->width, this->height));
+int VisualRhythm::get_band_number() const {
+    // Twice the number of threads, so that a slow band does not keep the other threads idle
+    return 2 * this->thread_pool->get_thread_number();
+}
+
+void VisualRhythm::subtract_residual(const Mat &image, const Mat &filtered, Mat &output) {
+    const KernelTable &kernels = get_kernels();
+    int cols = image.cols * image.channels();
+
+    output.create(image.size(), image.type());
+
+    for (int y = 0; y < image.rows; y++) {
+        kernels.subtract_row(image.ptr<uchar>(y), filtered.ptr<uchar>(y), output.ptr<uchar>(y),
+          cols);
+    }
+}
+
+void VisualRhythm::compute_noise_image_parallel(Mat &image, Mat &output) {
+    int rows = image.rows;
+    int band_number = std::min(get_band_number(), rows);
+
+    output.create(image.size(), image.type());
+
+    if (this->filter < 0 || this->filter > 2) {
+        cout << "Error:VisualRhythm::compute_noise_image():Invalid filter type" << endl;
+        return;
+    }
+
+    // The recursive gaussian has no finite halo, but its row pass is independent for each row
+    // and its column pass for each column, so the bands give the same result as the whole frame
+    if (this->filter == 2) {
+        RecursiveGaussian &gaussian = this->recursive_gaussian;
+        int cols = image.cols;
+        int column_band_number = std::min(get_band_number(), cols);
+
+        gaussian.set_sigma(this->variance);
+        gaussian.prepare(image);
+
+        this->thread_pool->parallel_for(band_number, [&](int band) {
+            int begin = 0, end = 0;
+            chunk_range(rows, band_number, band, begin, end);
+            gaussian.filter_rows(image, begin, end);
+        });
+
+        this->thread_pool->parallel_for(column_band_number, [&](int band) {
+            int begin = 0, end = 0;
+            chunk_range(cols, column_band_number, band, begin, end);
+            gaussian.filter_columns_residual(image, output, begin, end);
+        });
+
+        return;
+    }
+
+    this->thread_pool->parallel_for(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        Mat filtered_band;
+
+        chunk_range(rows, band_number, band, begin, end);
+
+        Mat output_band = output.rowRange(begin, end);
+        compute_residual_rows(image, begin, end, filtered_band, output_band);
+    });
+}
+
+void VisualRhythm::compute_residual_rows(const Mat &image, int begin, int end,
+  Mat &filtered_band, Mat &output_band) {
+
+    int halo = this->kernel_size / 2;
+    int top = std::max(0, begin - halo);
+    int bottom = std::min(image.rows, end + halo);
+
+    Mat image_band = image.rowRange(top, bottom);
+
+    if (this->filter == 0) {
+        cv::medianBlur(image_band, filtered_band, this->kernel_size);
+    } else {
+        cv::GaussianBlur(image_band, filtered_band,
+          cv::Size(this->kernel_size, this->kernel_size), this->variance);
+    }
+
+    subtract_residual(image.rowRange(begin, end), filtered_band.rowRange(begin - top, end - top),
+      output_band);
+}
+
+void VisualRhythm::compute_fused_spectrum(Mat &image, Mat &output) {
+    TraceScope trace("VisualRhythm::compute_fused_spectrum");
+    int rows = image.rows;
+    int band_number = is_parallel() ? std::min(get_band_number(), rows) : 1;
+
+    this->complex_frame.create(rows, image.cols, CV_32FC2);
+
+    // Each band is walked in blocks of rows: the noise of a block is transformed while it is
+    // still in the cache, and only the rows of the transform are written to the frame
+    run_bands(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        Mat filtered_block, noise_block;
 
-    output = Mat::zeros(roi.rows, roi.cols, CV_8U);
-    roi.convertTo(output, CV_8U);
+        chunk_range(rows, band_number, band, begin, end);
 
-    int y = 0, x = 0, x_dst = 0;
+        for (int block = begin; block < end; block += FUSION_BLOCK_ROWS) {
+            int block_end = std::min(block + FUSION_BLOCK_ROWS, end);
 
-    x_dst = this->current_frame * this->width;
+            noise_block.create(block_end - block, image.cols, image.type());
+            compute_residual_rows(image, block, block_end, filtered_block, noise_block);
 
-    for (y = 0; y < output.rows; y++) {
-        for (x = 0; x < output.cols; x++) {
-            this->visual_rhythm.at<uchar>(y, x_dst + x) = output.at<uchar>(y, x);
+            Mat complex_block = this->complex_frame.rowRange(block, block_end);
+            transform_rows(noise_block, complex_block);
         }
+    });
+
+    compute_spectrum_columns(output);
+}
+
+void VisualRhythm::transform_rows(const Mat &noise_band, Mat &complex_band) {
+
+    if (this->fast_spectrum) {
+        Mat real_band = Mat_<float>(noise_band);
+        dft(real_band, complex_band, DFT_ROWS | DFT_COMPLEX_OUTPUT);
+    } else {
+        Mat planes[] = { Mat_<float>(noise_band), Mat::zeros(noise_band.size(), CV_32F) };
+        merge(planes, 2, complex_band);
+        dft(complex_band, complex_band, DFT_ROWS);
+    }
+}
+
+void VisualRhythm::run_bands(int band_number, const std::function<void(int)> &body) {
+
+    if (is_parallel()) {
+        this->thread_pool->parallel_for(band_number, body);
+        return;
+    }
+
+    for (int band = 0; band < band_number; band++) {
+        body(band);
     }
 }
 
+void VisualRhythm::compute_fourier_spectrum_parallel(Mat &frame, Mat &output) {
+    int rows = frame.rows;
+    int band_number = std::min(get_band_number(), rows);
+
+    this->complex_frame.create(rows, frame.cols, CV_32FC2);
+
+    // Row pass of the 2-D transform
+    this->thread_pool->parallel_for(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(rows, band_number, band, begin, end);
+
+        Mat complex_band = this->complex_frame.rowRange(begin, end);
+        transform_rows(frame.rowRange(begin, end), complex_band);
+    });
+
+    compute_spectrum_columns(output);
+}
+
+void VisualRhythm::compute_spectrum_columns(Mat &output) {
+    Mat &complex_frame = this->complex_frame;
+    Mat &transposed_frame = this->transposed_frame;
+    Mat &magFrame = this->magnitude_frame;
+
+    int rows = complex_frame.rows;
+    int cols = complex_frame.cols;
+    int band_number = is_parallel() ? std::min(get_band_number(), std::min(rows, cols)) : 1;
+
+    transposed_frame.create(cols, rows, CV_32FC2);
+
+    // Column pass as a row pass over the transposed frame
+    run_bands(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(cols, band_number, band, begin, end);
+
+        Mat transposed_band = transposed_frame.rowRange(begin, end);
+        transpose(complex_frame.colRange(begin, end), transposed_band);
+
+        dft(transposed_band, transposed_band, DFT_ROWS);
+    });
+
+    if (this->fast_spectrum) {
+        int even_rows = rows & -2;
+        int even_cols = cols & -2;
+        vector<float> band_min(band_number, FLT_MAX);
+        vector<float> band_max(band_number, -FLT_MAX);
+
+        magFrame.create(even_rows, even_cols, CV_32F);
+
+        run_bands(band_number, [&](int band) {
+            int begin = 0, end = 0;
+            chunk_range(rows, band_number, band, begin, end);
+
+            Mat complex_band = complex_frame.rowRange(begin, end);
+            transpose(transposed_frame.colRange(begin, end), complex_band);
+
+            for (int y = begin; y < std::min(end, even_rows); y++) {
+                fast_log_magnitude(complex_frame.ptr<float>(y), magFrame.ptr<float>(y),
+                  even_cols, band_min[band], band_max[band]);
+            }
+        });
+
+        float min_value = *std::min_element(band_min.begin(), band_min.end());
+        float max_value = *std::max_element(band_max.begin(), band_max.end());
+
+        output.create(even_rows, even_cols, CV_8U);
+
+        run_bands(band_number, [&](int band) {
+            int begin = 0, end = 0;
+            chunk_range(even_rows, band_number, band, begin, end);
+
+            fast_normalize_shift(magFrame, output, min_value, max_value, begin, end);
+        });
+
+        return;
+    }
+
+    magFrame.create(rows, cols, CV_32F);
+
+    // Back to the frame layout, computing the log of the magnitude of each band
+    run_bands(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(rows, band_number, band, begin, end);
+
+        Mat complex_band = complex_frame.rowRange(begin, end);
+        transpose(transposed_frame.colRange(begin, end), complex_band);
+
+        Mat planes[2];
+        split(complex_band, planes);
+
+        Mat magnitude_band = magFrame.rowRange(begin, end);
+        magnitude(planes[0], planes[1], magnitude_band);
+
+        magnitude_band += Scalar::all(1);
+        log(magnitude_band, magnitude_band);
+    });
+
+    Mat shifted = magFrame(Rect(0, 0, magFrame.cols & -2, magFrame.rows & -2));
+    int cx = shifted.cols / 2;
+    int cy = shifted.rows / 2;
+
+    Mat q0(shifted, Rect(0, 0, cx, cy)); // Top-Left - Create a ROI per quadrant
+    Mat q1(shifted, Rect(cx, 0, cx, cy)); // Top-Right
+    Mat q2(shifted, Rect(0, cy, cx, cy)); // Bottom-Left
+    Mat q3(shifted, Rect(cx, cy, cx, cy)); // Bottom-Right
+
+    Mat tmp;
+    q0.copyTo(tmp);
+    q3.copyTo(q0);
+    tmp.copyTo(q3);
+
+    q1.copyTo(tmp); // swap quadrant (Top-Right with Bottom-Left)
+    q2.copyTo(q1);
+    tmp.copyTo(q2);
+
+    // Same scale used by normalize(CV_MINMAX), with the minimum and maximum of each band
+    // computed in parallel
+    int shifted_rows = shifted.rows;
+    vector<double> band_min(band_number, 0.0);
+    vector<double> band_max(band_number, 0.0);
+
+    run_bands(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(shifted_rows, band_number, band, begin, end);
+
+        if (begin < end) {
+            minMaxLoc(shifted.rowRange(begin, end), &band_min[band], &band_max[band]);
+        } else {
+            band_min[band] = DBL_MAX;
+            band_max[band] = -DBL_MAX;
+        }
+    });
+
+    double min_value = *std::min_element(band_min.begin(), band_min.end());
+    double max_value = *std::max_element(band_max.begin(), band_max.end());
+    double scale = (max_value - min_value) > DBL_EPSILON ? 255.0 / (max_value - min_value) : 0.0;
+    double shift = -min_value * scale;
+
+    output.create(shifted.rows, shifted.cols, CV_8U);
+
+    run_bands(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(shifted_rows, band_number, band, begin, end);
+
+        Mat normalized_band;
+        shifted.rowRange(begin, end).convertTo(normalized_band, -1, scale, shift);
+
+        Mat output_band = output.rowRange(begin, end);
+        normalized_band.convertTo(output_band, CV_8U);
+    });
+}
+
+void VisualRhythm::compute_fast_fourier_spectrum(Mat &frame, Mat &output) {
+    Mat &complex_frame = this->complex_frame;
+    Mat &magFrame = this->magnitude_frame;
+
+    // A real input transform gives the same spectrum of the complex transform with half of the
+    // operations
+    Mat real_frame = Mat_<float>(frame);
+    dft(real_frame, complex_frame, DFT_COMPLEX_OUTPUT);
+
+    int rows = frame.rows & -2;
+    int cols = frame.cols & -2;
+    float min_value = FLT_MAX;
+    float max_value = -FLT_MAX;
+
+    magFrame.create(rows, cols, CV_32F);
+
+    for (int y = 0; y < rows; y++) {
+        fast_log_magnitude(complex_frame.ptr<float>(y), magFrame.ptr<float>(y), cols, min_value,
+          max_value);
+    }
+
+    output.create(rows, cols, CV_8U);
+    fast_normalize_shift(magFrame, output, min_value, max_value, 0, rows);
+}
+
+template<int RhythmType>
+void VisualRhythm::extract_strip_specialized(Mat &spectrum, Mat &strip) {
+    TraceScope trace("VisualRhythm::extract_strip");
+
+    if (RhythmType == 0) {
+        compute_vertical_visual_rhythm(spectrum, strip);
+    } else if (RhythmType == 1) {
+        compute_horizontal_visual_rhythm(spectrum, strip);
+    } else {
+        compute_zigzag_visual_rhythm(spectrum, strip);
+    }
+}
+
+template<int RoiWidth>
+void VisualRhythm::place_strip_specialized(Mat &strip) {
+    TraceScope trace("VisualRhythm::place_strip");
+
+    if (this->window_length > 0) {
+        place_window_strip(strip);
+        return;
+    }
+
+    if (this->rhythm_writer.is_opened()) {
+        // The failure is reported when the visual rhythm is saved
+        if (!this->rhythm_writer.write_strip(strip)) {
+            this->is_write_failed = true;
+        }
+        return;
+    }
+
+    if (this->row_statistics.is_opened()) {
+        this->row_statistics.update(strip);
+        return;
+    }
+
+    // The frames after the last row of the strips (when the video does not stop at frame_number)
+    // are dropped
+    if (is_strips_full()) {
+        return;
+    }
+
+    // The rows of the strip are written one after the other in the row of the frame, and a width
+    // known at compile time lets the compiler unroll and vectorize the copy of each row
+    const int width = (RoiWidth > 0) ? RoiWidth : strip.cols;
+    uchar *dst = this->strips.ptr<uchar>(this->current_frame);
+
+    for (int y = 0; y < strip.rows; y++) {
+        const uchar *src = strip.ptr<uchar>(y);
+
+        for (int x = 0; x < width; x++) {
+            dst[x] = src[x];
+        }
+
+        dst += width;
+    }
+}
+
+void VisualRhythm::compute_vertical_visual_rhythm(Mat &frame, Mat &output) {
+    Mat roi;
+
+    roi = frame(
+            Rect((frame.cols / 2) - (this->width / 2), 0, this->width, this->height));
+
+    roi.copyTo(output);
+}
+
 void VisualRhythm::compute_horizontal_visual_rhythm(Mat &frame, Mat &output) {
-    Mat rot_mat, roi;
+    Mat rot_mat, roi, padded;
     int top, bottom, left, right;
     int borderType;
 
@@ -279,29 +1369,18 @@ void VisualRhythm::compute_horizontal_visual_rhythm(Mat &frame, Mat &output) {
 
     borderType = BORDER_CONSTANT;
 
-    copyMakeBorder(frame, frame, top, bottom, left, right, borderType, Scalar(0));
+    copyMakeBorder(frame, padded, top, bottom, left, right, borderType, Scalar(0));
 
-    Point center = Point(frame.cols / 2, frame.rows / 2);
+    Point center = Point(padded.cols / 2, padded.rows / 2);
     double angle = 90.0;
     double scale = 1.;
 
     rot_mat = getRotationMatrix2D(center, angle, scale);
 
-    warpAffine(frame, output, rot_mat, frame.size(), CV_INTER_LANCZOS4);
+    warpAffine(padded, output, rot_mat, padded.size(), CV_INTER_LANCZOS4);
 
     roi = output(Rect((output.cols / 2) - (this->width / 2), 0, this->width, this->height));
-    output = Mat::zeros(roi.rows, roi.cols, CV_8U);
-    roi.convertTo(output, CV_8U);
-
-    int y = 0, x = 0, x_dst = 0;
-
-    x_dst = this->current_frame * this->width;
-
-    for (y = 0; y < output.rows; y++) {
-        for (x = 0; x < output.cols; x++) {
-            this->visual_rhythm.at<uchar>(y, x_dst + x) = output.at<uchar>(y, x);
-        }
-    }
+    roi.copyTo(output);
 }
 
 void VisualRhythm::compute_zigzag_visual_rhythm(Mat &frame, Mat &output) {
@@ -351,18 +1430,6 @@ void VisualRhythm::compute_zigzag_visual_rhythm(Mat &frame, Mat &output) {
 
     }
 
-    output = Mat::zeros(roi.rows, roi.cols, CV_8U);
-    roi.convertTo(output, CV_8U);
-
-    int y = 0, x = 0, x_dst = 0;
-
-    x_dst = this->current_frame * this->width;
-
-    for (y = 0; y < output.rows; y++) {
-        for (x = 0; x < output.cols; x++) {
-            this->visual_rhythm.at<uchar>(y, x_dst + x) = output.at<uchar>(y, x);
-        }
-    }
-
+    roi.copyTo(output);
 }
 
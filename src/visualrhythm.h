@@ -56,6 +56,27 @@
 // Interface whose one method is used as callback function for process the frames
 #include "frameprocessor.h"
 
+// Pool of threads used to split the computation of a frame
+#include "threadpool.h"
+
+// Writer of visual rhythms strip by strip
+#include "rhythmwriter.h"
+
+// Running statistics of the rows of a visual rhythm over time
+#include "rowstatistics.h"
+
+// Linear model scoring the partial visual rhythm for the early decision
+#include "scorer.h"
+
+// Recursive approximation of the gaussian filter, with a cost independent of the variance
+#include "recursivegaussian.h"
+
+// Fourier transforms of batches of frames, vectorized across the frames
+#include "batchspectrum.h"
+
+#include <atomic>
+#include <map>
+
 using namespace std;
 using namespace cv;
 
@@ -64,9 +85,16 @@ class VisualRhythm: public FrameProcessor {
 
 private:
 
-    // Visual rhythm calculated
+    // Visual rhythm calculated, assembled from the strips when it is used
     Mat visual_rhythm;
 
+    // Strips of the frames, one row per frame holding the rows of its strip one after the other,
+    // so that placing a strip writes contiguous memory
+    Mat strips;
+
+    // Number of frames whose strips are already copied to the visual rhythm
+    int assembled_frame_number;
+
     // Type of visual rhythm to be computed
     int visual_rhythm_type;
 
@@ -91,25 +119,246 @@ private:
     // Variance value used during gaussian filtering
     float variance;
 
+    // To approximate the post-processing of the fourier spectrum (see fastspectrum.h)
+    bool fast_spectrum;
+
+    // To compute the noise image and the row pass of the transform together, in blocks of rows
+    // still in the cache, without writing the whole noise image
+    bool row_fusion;
+
     // Output file name of the visual rhythm computed
     string output_filename;
 
+    // Scratch buffers kept between frames (and between videos) to avoid reallocations
+    Mat image;
+    Mat noise;
+    Mat spectrum;
+    Mat filtered;
+    Mat color_frame;
+    vector<Mat> bands;
+    Mat complex_frame;
+    Mat transposed_frame;
+    Mat magnitude_frame;
+
+    // Recursive gaussian filter used with filter 2
+    RecursiveGaussian recursive_gaussian;
+
+    // Noise images waiting for their spectra, and the number of frames of a batch (1 means
+    // that each spectrum is computed when its frame arrives)
+    BatchSpectrum batch_spectrum;
+    int spectrum_batch;
+
+    // Number of duplicates following each frame of the batch of spectra
+    vector<int> batch_duplicates;
+
+    // To reuse the strip of the previous frame when a decoded frame is identical to it
+    bool skip_duplicates;
+
+    // Fingerprint of the previous decoded frame, and whether there is one
+    uint64_t last_fingerprint;
+    bool has_fingerprint;
+
+    // Strip of the previous frame, placed again for its duplicates
+    Mat last_strip;
+
+    // Number of frames found identical to the previous one since the last reset
+    int duplicate_frame_number;
+
+    // Writer used when the strips are streamed to the output file instead of kept in memory
+    RhythmWriter rhythm_writer;
+
+    // Statistics of the rows updated with each strip, used instead of keeping the strips
+    RowStatistics row_statistics;
+
+    // Did a write of a streamed strip or of a window fail since the last reset?
+    bool is_write_failed;
+
+    // Pool of threads used to split each frame in bands of rows (NULL means sequential)
+    ThreadPool *thread_pool;
+
+    // Model scoring the partial visual rhythm and its filename (empty means no early decision)
+    LinearScorer scorer;
+    string score_model;
+
+    // Number of frames between two evaluations of the score
+    int score_interval;
+
+    // Score above which the access is accepted as genuine
+    float accept_threshold;
+
+    // Score below which the access is rejected as an attack
+    float reject_threshold;
+
+    // Last score computed
+    float score;
+
+    // Spectra of the frames kept for the caller, stacked by rows (empty when they are not kept)
+    Mat spectra;
+
+    // Number of spectra kept (0 means that the spectra are not kept)
+    int spectrum_number;
+
+    // Number of frames when the score crossed a threshold (0 means no decision). It is read by
+    // the thread decoding the frames when the stages are pipelined.
+    std::atomic<int> decision_frame;
+
+    // Number of frames of each window, 0 means one visual rhythm from the first frames
+    int window_length;
+
+    // Number of frames between the first frames of two consecutive windows
+    int window_stride;
+
+    // Largest number of windows (0 means all windows of the video)
+    int max_windows;
+
+    // Visual rhythms of the windows not yet complete, by window index
+    map<int, Mat> windows;
+
+    // Visual rhythms of saved windows, reused by the next windows
+    vector<Mat> free_windows;
+
+    // Image of the window being saved, assembled from the strips of the window
+    Mat window_image;
+
+    // Number of windows saved
+    int saved_window_number;
+
+    // Pointer to a member function processing one frame
+    typedef void (VisualRhythm::*FrameFunction)(Mat &frame, Mat &output);
+
+    // Pipeline specialized for the current parameters (NULL until the first frame is processed)
+    FrameFunction process_frame;
+
     // Process the video frames
     void process(cv::Mat &frame, cv::Mat &output);
 
-    // To compute the noise image of a frame
-    void compute_noise_image(Mat &gray, Mat &output);
+    // To get the number of stages of the pipelined processing
+    int get_stage_number() const;
 
-    // To compute the fourier spectrum of a noise image
-    void compute_fourier_spectrum(Mat &frame, Mat &output);
+    // To process one stage of a frame: color conversion, noise residual, spectrum and strip
+    void process_stage(int stage, cv::Mat &input, cv::Mat &output);
+
+    // To extract the strip of the current type of visual rhythm and place it
+    void compute_strip(Mat &spectrum, Mat &strip);
+
+    // To process a frame adding its noise image to the batch of spectra
+    void process_batched(cv::Mat &frame, cv::Mat &output);
+
+    // To compute the spectra of the batch and place their strips, in the order of the frames
+    void compute_batch_strips(cv::Mat &output);
+
+    // To process the frames still in the batch of spectra
+    void finish();
+
+    // Is the frame identical to the previous one? Its fingerprint becomes the previous one
+    bool is_duplicate_frame(const Mat &frame);
+
+    // To place the strip of the previous frame for a duplicate, or to count it in the batch
+    void place_duplicate_frame(Mat &output);
+
+    // To place the strip of the previous frame again, as the strip of the current frame
+    void place_duplicate_strip();
+
+    // To swap the quadrants of log(1 + |X|) and scale it to an 8-bit spectrum
+    void shift_normalize_spectrum(Mat &magnitude, Mat &output);
+
+    // To keep the spectrum of the current frame, if the spectra are kept
+    void keep_spectrum(const Mat &spectrum);
+
+    // To score the partial visual rhythm every score_interval frames and take a decision
+    void check_score();
+
+    // To place the strip of the current frame into every window covering it, saving the windows
+    // completed by the frame
+    void place_window_strip(Mat &strip);
 
-    // To compute the vertical visual rhythm
+    // Are all rows of the strips placed? The strips of later frames are dropped
+    bool is_strips_full() const;
+
+    // To copy the strips of the frames not yet assembled, up to frame_number, to the visual rhythm
+    void assemble_visual_rhythm(int frame_number);
+
+    // To get the output file name of a window: the output file name with the window index
+    string get_window_filename(int window) const;
+
+    // To process a frame with the parameters fixed at compile time (a RoiWidth of 0 is read at run time)
+    template<int ColorSpace, int Filter, int RhythmType, int RoiWidth>
+    void process_specialized(Mat &frame, Mat &output);
+
+    // To select the specialized pipeline matching the current parameters, once per video
+    void select_pipeline();
+
+    // To select the specialized pipeline for the filter of the frames
+    template<int ColorSpace>
+    FrameFunction select_filter() const;
+
+    // To select the specialized pipeline for the type of visual rhythm
+    template<int ColorSpace, int Filter>
+    FrameFunction select_rhythm_type() const;
+
+    // To select the specialized pipeline for the width of the visual rhythm
+    template<int ColorSpace, int Filter, int RhythmType>
+    FrameFunction select_roi_width() const;
+
+    // To convert a frame to the color space given at compile time
+    template<int ColorSpace>
+    void convert_color_space_specialized(Mat &frame, Mat &output);
+
+    // To compute the noise image with the filter given at compile time
+    template<int Filter>
+    void compute_noise_image_specialized(Mat &image, Mat &output);
+
+    // To extract the strip of the type of visual rhythm given at compile time
+    template<int RhythmType>
+    void extract_strip_specialized(Mat &spectrum, Mat &strip);
+
+    // To place a strip with the width given at compile time into the visual rhythm
+    template<int RoiWidth>
+    void place_strip_specialized(Mat &strip);
+
+    // To compute the residual noise image - filtered image, saturated at zero
+    void subtract_residual(const Mat &image, const Mat &filtered, Mat &output);
+
+    // To compute the noise image splitting the frame in bands of rows processed in parallel
+    void compute_noise_image_parallel(Mat &image, Mat &output);
+
+    // To compute the noise of the rows [begin, end) filtering them with kernel_size/2 rows of
+    // their neighbours, so that they are the same rows obtained by filtering the whole frame
+    void compute_residual_rows(const Mat &image, int begin, int end, Mat &filtered_band,
+      Mat &output_band);
+
+    // To compute the fourier spectrum with parallel row and column passes of the transform
+    void compute_fourier_spectrum_parallel(Mat &frame, Mat &output);
+
+    // To compute the noise image and the row pass of the transform in blocks of rows, then the
+    // column pass (filters 0 and 1)
+    void compute_fused_spectrum(Mat &image, Mat &output);
+
+    // To transform each row of a band of the noise image into the rows of complex_frame
+    void transform_rows(const Mat &noise_band, Mat &complex_band);
+
+    // To compute the column pass of the transform in complex_frame, and the spectrum from it
+    void compute_spectrum_columns(Mat &output);
+
+    // To run body(band) for every band, in parallel when the frame is computed in parallel
+    void run_bands(int band_number, const std::function<void(int)> &body);
+
+    // To compute the approximate fourier spectrum
+    void compute_fast_fourier_spectrum(Mat &frame, Mat &output);
+
+    // To get the number of bands of rows a frame is split when running in parallel
+    int get_band_number() const;
+
+    // Is the frame computed in parallel?
+    bool is_parallel() const;
+
+    // To extract the strip of the vertical visual rhythm from a spectrum
     void compute_vertical_visual_rhythm(Mat &frame, Mat &output);
 
-    // To compute the horizontal visual rhythm
+    // To extract the strip of the horizontal visual rhythm from a spectrum
     void compute_horizontal_visual_rhythm(Mat &frame, Mat &output);
 
-    // To compute the zigzag visual rhythm
+    // To extract the strip of the zigzag visual rhythm from a spectrum
     void compute_zigzag_visual_rhythm(Mat &frame, Mat &output);
 
 public:
@@ -120,9 +369,33 @@ public:
     // Destructor
     ~VisualRhythm();
 
+    // To convert a frame to the color space where the noise is extracted
+    void convert_color_space(Mat &frame, Mat &output);
+
+    // To compute the noise image of a frame
+    void compute_noise_image(Mat &gray, Mat &output);
+
+    // To compute the fourier spectrum of a noise image
+    void compute_fourier_spectrum(Mat &frame, Mat &output);
+
     // To create a matrix used to store the computed visual rhythm
     void set_visual_rhythm(Mat visual_rhythm);
 
+    // To get the computed visual rhythm, assembling the strips placed since the last call
+    Mat get_visual_rhythm();
+
+    // To get the strips of the frames, one row per frame (the layout used while computing)
+    Mat get_strips() const;
+
+    // To get the number of frames processed since the last reset
+    int get_frame_number() const;
+
+    // To allocate the visual rhythm, reusing the current allocation when the size is the same
+    void create_visual_rhythm(int rows, int cols);
+
+    // To restart the computation for a new video
+    void reset();
+
     // To set type of the visual rhythm to be computed
     void set_visual_rhythm_type(int visual_rhythm_type);
 
@@ -138,6 +411,54 @@ public:
     // To set the variance value used in the gaussian filter
     void set_variance(float variance);
 
+    // To set whether the post-processing of the fourier spectrum is approximated
+    void set_fast_spectrum(bool fast_spectrum);
+
+    // To set whether the noise image and the row pass of the transform are computed together
+    void set_row_fusion(bool row_fusion);
+
+    // To set whether a decoded frame identical to the previous one reuses its strip instead of
+    // being processed again
+    void set_skip_duplicates(bool skip_duplicates);
+
+    // To get the number of frames found identical to the previous one since the last reset
+    int get_duplicate_frame_number() const;
+
+    // To set the number of frames whose spectra are computed together (1 computes each spectrum
+    // alone). The strips are placed when the batch is full and when the video ends.
+    void set_spectrum_batch(int spectrum_batch);
+
+    // To set the pool of threads used to compute each frame in parallel
+    void set_thread_pool(ThreadPool *thread_pool);
+
+    // To set the model scoring the partial visual rhythm, it is loaded again only when the
+    // filename changes (an empty filename disables the early decision)
+    bool set_score_model(const string &score_model);
+
+    // To set the number of frames between two evaluations of the score
+    void set_score_interval(int score_interval);
+
+    // To set the scores below which an attack is decided and above which a genuine access is
+    void set_score_thresholds(float reject_threshold, float accept_threshold);
+
+    // Was a decision taken before the end of the video?
+    bool is_done();
+
+    // To get the last score computed
+    float get_score() const;
+
+    // To get the decision: 1 for a genuine access, -1 for an attack and 0 for no decision
+    int get_decision() const;
+
+    // To get the number of frames used to take the decision (0 means no decision)
+    int get_decision_frame() const;
+
+    // To keep the spectra of the first frames in a single buffer (0 does not keep them)
+    void set_spectrum_number(int spectrum_number);
+
+    // To get the spectra kept, stacked by rows (each spectrum has get_spectra().rows / frames rows)
+    Mat get_spectra() const;
+
     // To set the height of the visual rhythm
     void set_height(int height);
 
@@ -150,8 +471,27 @@ public:
     // To calculate the dimensions of the visual rhythm to be computed.
     int compute_dimensions_visual_rhythm(int rows, int cols);
 
-    // To save the computed visual rhythm
-    void save_visual_rhythm();
+    // To stream the strips to the output file (transposed PGM) as they are computed, instead of
+    // keeping the visual rhythm in memory. It must be called after setting the height.
+    bool open_streaming_output();
+
+    // To keep only the statistics of each row of the visual rhythm over time, saved as a text
+    // descriptor instead of the visual rhythm. It must be called after setting the height.
+    void open_row_statistics();
+
+    // To save the computed visual rhythm, returns false if the output (or a streamed strip or a
+    // window written before) could not be written
+    bool save_visual_rhythm();
+
+    // To compute a visual rhythm for each window of window_length frames, starting every
+    // window_stride frames, from one pass over the video (a window_length of 0 disables them)
+    void set_windows(int window_length, int window_stride, int max_windows);
+
+    // To get the number of frames to be processed to complete the windows (-1 means all frames)
+    int get_window_frame_number() const;
+
+    // To get the number of windows saved since the last reset
+    int get_saved_window_number() const;
 
 };
 
@@ -0,0 +1,456 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// End-to-end benchmark of VisualRhythmAntiSpoofing over a corpus of videos, for example the
+// videos generated by VisualRhythmSynth.
+// Usage: VisualRhythmBenchmark -videos <list> [-program <path>] [-threads 1,2,4,...]
+//   [-repeat n] [-work_dir <dir>] [-output <report.json>] [options of VisualRhythmAntiSpoofing]
+// The list has the filename of one video per line. For each number of threads t the program is
+// run in four modes: single (the first video with -threads t), batch (all the videos in one
+// batch with -threads t), parallel (t processes, each one with a batch of 1/t of the videos and
+// one thread) and weak (t copies of the videos in one batch with -threads t). Each run is a new
+// process, whose wall time and peak resident memory (from wait4) are measured, and the median of
+// the repetitions is kept. The report, in JSON, has the frames and videos per second, the peak
+// memory and the speedup and efficiency of each mode relative to the first number of threads;
+// the work of the weak mode grows with t, so its efficiency is the ratio of the times.
+
+#include "kernels.h"
+#include "parameters.h"
+#include "video.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Video of the corpus
+struct BenchmarkVideo {
+    string filename;
+    long frames;
+    int width;
+    int height;
+};
+
+// Measures of one run of the program (one or more processes)
+struct RunResult {
+    double seconds;
+    long peak_rss_kb;
+    long total_rss_kb;
+    bool is_ok;
+};
+
+// Measures of one mode with one number of threads
+struct BenchmarkPoint {
+    int threads;
+    int processes;
+    long frames;
+    long videos;
+    RunResult result;
+};
+
+// To start the program with the given arguments, with its standard output discarded. Returns the
+// process identifier, -1 on errors.
+pid_t start_program(const vector<string> &arguments) {
+    vector<char*> argv;
+
+    for (size_t i = 0; i < arguments.size(); i++) {
+        argv.push_back(const_cast<char*>(arguments[i].c_str()));
+    }
+
+    argv.push_back(NULL);
+
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+
+        if (null_fd >= 0) {
+            dup2(null_fd, STDOUT_FILENO);
+            close(null_fd);
+        }
+
+        execv(argv[0], &argv[0]);
+        _exit(127);
+    }
+
+    return pid;
+}
+
+// To run the commands at the same time, each one in its own process, and wait for all of them
+RunResult run_commands(const vector< vector<string> > &commands) {
+    RunResult result = { 0.0, 0, 0, true };
+    vector<pid_t> pids;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < commands.size(); i++) {
+        pid_t pid = start_program(commands[i]);
+
+        if (pid < 0) {
+            result.is_ok = false;
+        } else {
+            pids.push_back(pid);
+        }
+    }
+
+    for (size_t i = 0; i < pids.size(); i++) {
+        int status = 0;
+        struct rusage usage;
+
+        if (wait4(pids[i], &status, 0, &usage) < 0) {
+            result.is_ok = false;
+            continue;
+        }
+
+        result.is_ok = result.is_ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        result.peak_rss_kb = std::max(result.peak_rss_kb, static_cast<long>(usage.ru_maxrss));
+        result.total_rss_kb += usage.ru_maxrss;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+
+    return result;
+}
+
+// To run the commands repeat times, keeping the median time and the largest memory
+RunResult repeat_commands(const vector< vector<string> > &commands, int repeat) {
+    vector<double> seconds;
+    RunResult result = { 0.0, 0, 0, true };
+
+    for (int r = 0; r < repeat; r++) {
+        RunResult run = run_commands(commands);
+
+        seconds.push_back(run.seconds);
+        result.is_ok = result.is_ok && run.is_ok;
+        result.peak_rss_kb = std::max(result.peak_rss_kb, run.peak_rss_kb);
+        result.total_rss_kb = std::max(result.total_rss_kb, run.total_rss_kb);
+    }
+
+    sort(seconds.begin(), seconds.end());
+    result.seconds = seconds[seconds.size() / 2];
+
+    return result;
+}
+
+// To write a manifest with one line per video, copies times, with its own output image each
+bool write_manifest(const string &filename, const vector<BenchmarkVideo> &videos,
+  const vector<int> &indices, int copies, const string &output_prefix) {
+
+    ofstream manifest(filename.c_str());
+
+    for (int c = 0; c < copies; c++) {
+        for (size_t i = 0; i < indices.size(); i++) {
+            manifest << "-input_video \"" << videos[indices[i]].filename << "\" -output_image \"";
+            manifest << output_prefix << "_" << c << "_" << indices[i] << ".png\"" << endl;
+        }
+    }
+
+    return manifest.good();
+}
+
+// To write a string as a JSON string
+string json_string(const string &text) {
+    string quoted = "\"";
+
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '"' || text[i] == '\\') {
+            quoted += '\\';
+        }
+
+        quoted += text[i];
+    }
+
+    return quoted + "\"";
+}
+
+// To write the points of one mode as a JSON array
+void write_points(ostream &report, const vector<BenchmarkPoint> &points, bool is_weak) {
+    report << "[";
+
+    for (size_t i = 0; i < points.size(); i++) {
+        const BenchmarkPoint &point = points[i];
+        const BenchmarkPoint &base = points[0];
+        double seconds = std::max(point.result.seconds, 1e-9);
+        double ratio = base.result.seconds / seconds;
+        double scale = static_cast<double>(point.threads) / base.threads;
+
+        // Strong scaling: the same work in less time. Weak scaling: more work in the same time.
+        double speedup = is_weak ? ratio * scale : ratio;
+        double efficiency = is_weak ? ratio : ratio / scale;
+
+        report << (i == 0 ? "\n" : ",\n") << "      {";
+        report << "\"threads\": " << point.threads;
+        report << ", \"processes\": " << point.processes;
+        report << ", \"frames\": " << point.frames;
+        report << ", \"videos\": " << point.videos;
+        report << ", \"seconds\": " << point.result.seconds;
+        report << ", \"frames_per_second\": " << point.frames / seconds;
+        report << ", \"videos_per_second\": " << point.videos / seconds;
+        report << ", \"peak_rss_kb\": " << point.result.peak_rss_kb;
+        report << ", \"total_rss_kb\": " << point.result.total_rss_kb;
+        report << ", \"speedup\": " << speedup;
+        report << ", \"efficiency\": " << efficiency;
+        report << ", \"ok\": " << (point.result.is_ok ? "true" : "false") << "}";
+    }
+
+    report << "\n    ]";
+}
+
+int main(int argc, char** argv) {
+
+    string videos_filename = "";
+    string program = "./Release/VisualRhythmAntiSpoofing";
+    string threads_list = "1,2,4";
+    string work_dir = "/tmp/visualrhythm_benchmark";
+    string output = "";
+    int repeat = 1;
+    vector<string> options;
+    bool is_valid = true;
+
+    for (int i = 1; i < argc; i++) {
+        string argument = string(argv[i]);
+
+        if (argument.compare("-videos") == 0 && (i + 1) < argc) {
+            videos_filename = string(argv[++i]);
+        } else if (argument.compare("-program") == 0 && (i + 1) < argc) {
+            program = string(argv[++i]);
+        } else if (argument.compare("-threads") == 0 && (i + 1) < argc) {
+            threads_list = string(argv[++i]);
+        } else if (argument.compare("-repeat") == 0 && (i + 1) < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (argument.compare("-work_dir") == 0 && (i + 1) < argc) {
+            work_dir = string(argv[++i]);
+        } else if (argument.compare("-output") == 0 && (i + 1) < argc) {
+            output = string(argv[++i]);
+        } else if (argument.compare("-input_video") == 0 ||
+              argument.compare("-output_image") == 0 || argument.compare("-batch") == 0) {
+
+            // These options are given by the benchmark to each run
+            is_valid = false;
+        } else {
+            options.push_back(argument);
+        }
+    }
+
+    vector<int> thread_numbers;
+    stringstream threads_stream(threads_list);
+    string number;
+
+    while (getline(threads_stream, number, ',')) {
+        thread_numbers.push_back(atoi(number.c_str()));
+        is_valid = is_valid && thread_numbers.back() >= 1;
+    }
+
+    if (!is_valid || videos_filename.empty() || thread_numbers.empty() || repeat < 1) {
+        cout << "Usage: " << argv[0] << " -videos <list> [-program <path>] [-threads 1,2,4,...] ";
+        cout << "[-repeat n] [-work_dir <dir>] [-output <report.json>] [options]" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // The frames computed of each video are limited by -frame_number, as in the program
+    Parameters defaults;
+    long frame_number = defaults.frame_number;
+    string cpu_level = defaults.cpu_level;
+
+    for (size_t i = 0; i + 1 < options.size(); i++) {
+        if (options[i].compare("-frame_number") == 0) {
+            frame_number = atol(options[i + 1].c_str());
+        } else if (options[i].compare("-cpu_level") == 0) {
+            cpu_level = options[i + 1];
+        }
+    }
+
+    vector<BenchmarkVideo> videos;
+    ifstream list(videos_filename.c_str());
+    string line;
+
+    while (getline(list, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        Video processor;
+        BenchmarkVideo video = { line, 0, 0, 0 };
+
+        if (!processor.set_input_video(line)) {
+            cout << "Error:main():Could not open " << line << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        video.frames = std::min(processor.get_total_frame_count(), frame_number);
+        video.width = processor.get_frame_width();
+        video.height = processor.get_frame_height();
+        videos.push_back(video);
+    }
+
+    if (videos.empty()) {
+        cout << "Error:main():No videos in " << videos_filename << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    mkdir(work_dir.c_str(), 0755);
+
+    long corpus_frames = 0;
+    vector<int> all_videos;
+
+    for (size_t i = 0; i < videos.size(); i++) {
+        corpus_frames += videos[i].frames;
+        all_videos.push_back(static_cast<int>(i));
+    }
+
+    const char *mode_names[] = { "single", "batch", "parallel", "weak" };
+    vector<BenchmarkPoint> points[4];
+    bool is_ok = true;
+
+    for (size_t n = 0; n < thread_numbers.size(); n++) {
+        const int threads = thread_numbers[n];
+        stringstream threads_text;
+        threads_text << threads;
+
+        vector<string> base(1, program);
+        base.insert(base.end(), options.begin(), options.end());
+        base.push_back("-threads");
+        base.push_back(threads_text.str());
+
+        for (int mode = 0; mode < 4; mode++) {
+            string prefix = work_dir + "/" + mode_names[mode] + "_" + threads_text.str();
+            vector< vector<string> > commands;
+            BenchmarkPoint point = { threads, 1, 0, 0, { 0.0, 0, 0, true } };
+
+            if (mode == 0) {
+                commands.push_back(base);
+                commands[0].push_back("-input_video");
+                commands[0].push_back(videos[0].filename);
+                commands[0].push_back("-output_image");
+                commands[0].push_back(prefix + ".png");
+                point.frames = videos[0].frames;
+                point.videos = 1;
+            } else if (mode == 1 || mode == 3) {
+                int copies = (mode == 3) ? threads : 1;
+
+                write_manifest(prefix + ".txt", videos, all_videos, copies, prefix);
+                commands.push_back(base);
+                commands[0].push_back("-batch");
+                commands[0].push_back(prefix + ".txt");
+                point.frames = corpus_frames * copies;
+                point.videos = static_cast<long>(videos.size()) * copies;
+            } else {
+
+                // One thread per process, the videos dealt among the processes
+                for (int p = 0; p < threads && p < static_cast<int>(videos.size()); p++) {
+                    vector<int> indices;
+                    stringstream manifest;
+                    manifest << prefix << "_" << p << ".txt";
+
+                    for (size_t i = p; i < videos.size(); i += threads) {
+                        indices.push_back(static_cast<int>(i));
+                    }
+
+                    write_manifest(manifest.str(), videos, indices, 1, prefix);
+                    commands.push_back(vector<string>(1, program));
+                    commands.back().insert(commands.back().end(), options.begin(), options.end());
+                    commands.back().push_back("-batch");
+                    commands.back().push_back(manifest.str());
+                }
+
+                point.processes = static_cast<int>(commands.size());
+                point.frames = corpus_frames;
+                point.videos = static_cast<long>(videos.size());
+            }
+
+            point.result = repeat_commands(commands, repeat);
+            points[mode].push_back(point);
+            is_ok = is_ok && point.result.is_ok;
+
+            cout << mode_names[mode] << " threads " << threads << ": ";
+            cout << point.result.seconds << " s, ";
+            cout << point.frames / std::max(point.result.seconds, 1e-9) << " frames/s, ";
+            cout << point.result.peak_rss_kb << " KB";
+            cout << (point.result.is_ok ? "" : " (failed)") << endl;
+        }
+    }
+
+    // Report
+    ofstream file;
+
+    if (!output.empty()) {
+        file.open(output.c_str());
+    }
+
+    ostream &report = output.empty() ? cout : file;
+    string option_text = "";
+
+    for (size_t i = 0; i < options.size(); i++) {
+        option_text += (i == 0 ? "" : " ") + options[i];
+    }
+
+    report << "{" << endl;
+    report << "  \"program\": " << json_string(program) << "," << endl;
+    report << "  \"options\": " << json_string(option_text) << "," << endl;
+    report << "  \"cores\": " << std::thread::hardware_concurrency() << "," << endl;
+    report << "  \"kernel_level\": ";
+    report << json_string(get_kernel_level_name(get_kernel_level_by_name(cpu_level))) << ",";
+    report << endl << "  \"repeat\": " << repeat << "," << endl;
+    report << "  \"videos\": [";
+
+    for (size_t i = 0; i < videos.size(); i++) {
+        report << (i == 0 ? "\n" : ",\n") << "    {\"filename\": ";
+        report << json_string(videos[i].filename) << ", \"frames\": " << videos[i].frames;
+        report << ", \"width\": " << videos[i].width << ", \"height\": " << videos[i].height;
+        report << "}";
+    }
+
+    report << "\n  ]," << endl;
+    report << "  \"modes\": {";
+
+    for (int mode = 0; mode < 4; mode++) {
+        report << (mode == 0 ? "\n" : ",\n") << "    " << json_string(mode_names[mode]) << ": ";
+        write_points(report, points[mode], mode == 3);
+    }
+
+    report << "\n  }" << endl;
+    report << "}" << endl;
+
+    if (!output.empty() && !file.good()) {
+        cout << "Error:main():Could not write " << output << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return is_ok ? 0 : EXIT_FAILURE;
+}
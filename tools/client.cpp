@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Client of the extraction server: sends the given options as a single request and prints the
+// reply. Usage: VisualRhythmClient -socket <path> [options of VisualRhythmAntiSpoofing | SHUTDOWN]
+
+#include "server.h"
+
+#include <unistd.h>
+
+int main(int argc, char** argv) {
+
+    string socket_path = "";
+    string request = "";
+    string buffer = "";
+    string reply = "";
+
+    for (int i = 1; i < argc; i++) {
+        string argument = string(argv[i]);
+
+        if (argument.compare("-socket") == 0 && (i + 1) < argc) {
+            socket_path = string(argv[++i]);
+        } else {
+            if (!request.empty()) {
+                request += " ";
+            }
+
+            if (argument.find_first_of(" \t") != string::npos) {
+                request += "\"" + argument + "\"";
+            } else {
+                request += argument;
+            }
+        }
+    }
+
+    if (socket_path.empty() || request.empty()) {
+        cout << "Usage: " << argv[0] << " -socket <path> [options | SHUTDOWN]" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    int fd = connect_server(socket_path);
+
+    if (fd < 0) {
+        cout << "Error:main():Could not connect to " << socket_path << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (!write_line(fd, request) || !read_line(fd, buffer, reply)) {
+        cout << "Error:main():Connection closed by the server" << endl;
+        close(fd);
+        exit(EXIT_FAILURE);
+    }
+
+    close(fd);
+
+    cout << reply << endl;
+
+    return (reply.compare(0, 2, "OK") == 0) ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,187 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Load generator for the extraction server: opens several connections at the same time, each one
+// sending a sequence of requests, and reports the latency distribution of the replies.
+// Usage: VisualRhythmLoadTest -socket <path> -connections <c> -requests <n> [options]
+// The text %n inside the options is replaced by a unique request number, so that each request
+// may write to its own output image.
+
+#include "server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include <unistd.h>
+
+// Latencies (in milliseconds) and failures of one connection
+struct ConnectionResult {
+    vector<double> latencies;
+    int failures;
+};
+
+void run_connection(string socket_path, string request, int connection, int requests,
+  ConnectionResult *result) {
+
+    string buffer = "";
+    string reply = "";
+
+    result->failures = 0;
+
+    int fd = connect_server(socket_path);
+
+    if (fd < 0) {
+        result->failures = requests;
+        return;
+    }
+
+    for (int i = 0; i < requests; i++) {
+        string line = request;
+        char number[32];
+        size_t pos = 0;
+
+        snprintf(number, sizeof(number), "%d", connection * requests + i);
+
+        while ((pos = line.find("%n", pos)) != string::npos) {
+            line.replace(pos, 2, number);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if (!write_line(fd, line) || !read_line(fd, buffer, reply)) {
+            result->failures += requests - i;
+            break;
+        }
+
+        std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+        if (reply.compare(0, 2, "OK") == 0) {
+            result->latencies.push_back(elapsed.count());
+        } else {
+            result->failures++;
+        }
+    }
+
+    close(fd);
+}
+
+double percentile(const vector<double> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+
+    string socket_path = "";
+    string request = "";
+    int connections = 4;
+    int requests = 10;
+
+    for (int i = 1; i < argc; i++) {
+        string argument = string(argv[i]);
+
+        if (argument.compare("-socket") == 0 && (i + 1) < argc) {
+            socket_path = string(argv[++i]);
+        } else if (argument.compare("-connections") == 0 && (i + 1) < argc) {
+            connections = atoi(argv[++i]);
+        } else if (argument.compare("-requests") == 0 && (i + 1) < argc) {
+            requests = atoi(argv[++i]);
+        } else {
+            if (!request.empty()) {
+                request += " ";
+            }
+
+            if (argument.find_first_of(" \t") != string::npos) {
+                request += "\"" + argument + "\"";
+            } else {
+                request += argument;
+            }
+        }
+    }
+
+    if (socket_path.empty() || request.empty() || connections < 1 || requests < 1) {
+        cout << "Usage: " << argv[0] << " -socket <path> -connections <c> -requests <n> ";
+        cout << "[options]" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<ConnectionResult> results(connections);
+    vector<std::thread> threads;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int c = 0; c < connections; c++) {
+        threads.push_back(std::thread(run_connection, socket_path, request, c, requests,
+          &results[c]));
+    }
+
+    for (int c = 0; c < connections; c++) {
+        threads[c].join();
+    }
+
+    std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+
+    vector<double> latencies;
+    int failures = 0;
+
+    for (int c = 0; c < connections; c++) {
+        latencies.insert(latencies.end(), results[c].latencies.begin(),
+          results[c].latencies.end());
+        failures += results[c].failures;
+    }
+
+    sort(latencies.begin(), latencies.end());
+
+    double sum = 0.0;
+    for (size_t i = 0; i < latencies.size(); i++) {
+        sum += latencies[i];
+    }
+
+    cout << "Requests: " << latencies.size() << " ok, " << failures << " failed" << endl;
+    cout << "Throughput: " << latencies.size() / wall_time.count() << " requests/s" << endl;
+
+    if (!latencies.empty()) {
+        cout << "Latency (ms): min " << latencies.front();
+        cout << ", mean " << sum / latencies.size();
+        cout << ", p50 " << percentile(latencies, 0.50);
+        cout << ", p90 " << percentile(latencies, 0.90);
+        cout << ", p99 " << percentile(latencies, 0.99);
+        cout << ", max " << latencies.back() << endl;
+    }
+
+    return (failures == 0) ? 0 : EXIT_FAILURE;
+}
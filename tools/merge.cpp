@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Merge of the partial datasets written by the shards of a batch (-shard i/N -dataset file) into
+// a single dataset. Usage: VisualRhythmMerge <output.vrds> <shard.vrds> [<shard.vrds> ...]
+// The visual rhythms are written in the order of their names, so the merged dataset does not
+// depend on the order of the shards nor on the order in which the videos were computed.
+
+#include "dataset.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+// Visual rhythm of a shard
+struct ShardEntry {
+    DatasetEntry entry;
+    size_t shard;
+};
+
+static bool is_before(const ShardEntry &a, const ShardEntry &b) {
+    return a.entry.name < b.entry.name;
+}
+
+int main(int argc, char** argv) {
+
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " <output.vrds> <shard.vrds> [<shard.vrds> ...]" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<DatasetReader> shards(argc - 2);
+    vector<ShardEntry> entries;
+
+    for (size_t i = 0; i < shards.size(); i++) {
+
+        if (!shards[i].open(argv[i + 2])) {
+            exit(EXIT_FAILURE);
+        }
+
+        const vector<DatasetEntry> &shard_entries = shards[i].get_entries();
+
+        for (size_t j = 0; j < shard_entries.size(); j++) {
+            ShardEntry entry = { shard_entries[j], i };
+            entries.push_back(entry);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), is_before);
+
+    DatasetWriter writer;
+    vector<char> data;
+
+    if (!writer.open(argv[1])) {
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < entries.size(); i++) {
+
+        // A video given to two shards means that the shards did not use the same manifest
+        if (i > 0 && entries[i].entry.name == entries[i - 1].entry.name) {
+            cout << "Error:main():" << entries[i].entry.name << " is in more than one shard";
+            cout << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        if (!shards[entries[i].shard].read(entries[i].entry, data) ||
+              !writer.add(entries[i].entry.name, data.empty() ? NULL : &data[0], data.size())) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!writer.close()) {
+        exit(EXIT_FAILURE);
+    }
+
+    cout << "Merged " << entries.size() << " visual rhythms from " << shards.size();
+    cout << " shards into " << argv[1] << endl;
+
+    return 0;
+}
@@ -0,0 +1,405 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Generator of deterministic synthetic videos, used to study the scaling of the extraction with
+// resolutions and lengths not found in EXAMPLE/data.
+// Usage: VisualRhythmSynth -output <file> [-resolution 480p|720p|1080p|2160p | -size WxH]
+//   [-frames n] [-fps f] [-codec fourcc] [-pattern genuine|print|replay] [-seed s]
+// The scene is a textured background with a shaded ellipse moving as a head. The pattern print
+// shows the scene as a printed photo held by hand: a still scene shaking as a whole, with the
+// reduced contrast of the paper, a halftone screen and the grain of the paper. The pattern replay
+// shows the scene on a screen: the moire of the pixel grid of the screen sampled by the camera
+// and the flicker of its backlight. Every pattern has sensor noise. Files ending in .y4m are
+// written as YUV4MPEG2 4:2:0, which is reproducible byte by byte; other files are encoded by
+// OpenCV with the given fourcc (default MJPG). The same parameters always give the same frames.
+
+#include "video.h"
+
+#include <cmath>
+#include <cstdio>
+
+// Margin of the background around the frame, covering the shaking of the photo and the camera
+#define SYNTH_MARGIN 16
+
+// Parameters of a synthetic video
+struct SynthParameters {
+    string output;
+    int width;
+    int height;
+    int frames;
+    double fps;
+    string codec;
+    string pattern;
+    unsigned long long seed;
+};
+
+// To get the frame size of a named resolution, false for unknown names
+bool get_resolution(const string &name, int &width, int &height) {
+    const char *names[] = { "480p", "720p", "1080p", "2160p" };
+    const int widths[] = { 640, 1280, 1920, 3840 };
+    const int heights[] = { 480, 720, 1080, 2160 };
+
+    for (int i = 0; i < 4; i++) {
+        if (name.compare(names[i]) == 0) {
+            width = widths[i];
+            height = heights[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Writer of YUV4MPEG2 files with 4:2:0 chroma, which needs no codec
+class Y4MWriter {
+
+private:
+
+    // Output file (NULL if no file is opened)
+    FILE *file;
+
+    // Scratch buffers of the conversion
+    Mat ycrcb;
+    vector<Mat> planes;
+    Mat chroma;
+
+public:
+
+    Y4MWriter() : file(NULL) {}
+
+    ~Y4MWriter() {
+        close();
+    }
+
+    bool open(const string &filename, int width, int height, double fps) {
+        this->file = fopen(filename.c_str(), "wb");
+
+        if (this->file == NULL) {
+            return false;
+        }
+
+        fprintf(this->file, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C420jpeg\n", width, height,
+          static_cast<int>(fps * 1000.0 + 0.5));
+
+        return true;
+    }
+
+    bool write(const Mat &frame) {
+        cvtColor(frame, this->ycrcb, CV_BGR2YCrCb);
+        split(this->ycrcb, this->planes);
+
+        bool is_written = fputs("FRAME\n", this->file) >= 0 && write_plane(this->planes[0]);
+
+        // The planes of YCrCb are in the order Y, Cr, Cb and those of the file in Y, Cb, Cr
+        Size chroma_size(frame.cols / 2, frame.rows / 2);
+
+        for (int p = 2; p >= 1; p--) {
+            resize(this->planes[p], this->chroma, chroma_size, 0, 0, INTER_AREA);
+            is_written = is_written && write_plane(this->chroma);
+        }
+
+        return is_written;
+    }
+
+    bool write_plane(const Mat &plane) {
+        for (int y = 0; y < plane.rows; y++) {
+            if (fwrite(plane.ptr<uchar>(y), 1, plane.cols, this->file) !=
+                  static_cast<size_t>(plane.cols)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool close() {
+        bool is_closed = true;
+
+        if (this->file != NULL) {
+            is_closed = fclose(this->file) == 0;
+            this->file = NULL;
+        }
+
+        return is_closed;
+    }
+};
+
+// Generator of the frames of a synthetic video
+class SynthVideo {
+
+private:
+
+    // Parameters of the video
+    SynthParameters parameters;
+
+    // Background with the margin, low frequency colored texture
+    Mat background;
+
+    // Gain of the halftone screen and the paper of the print (3 channels), empty for other
+    // patterns
+    Mat gain;
+
+    // Offset of the moire of the screen (3 channels), empty for other patterns
+    Mat moire;
+
+    // Sensor noise of the current frame
+    Mat noise;
+
+    // Scene of the current frame, in floating point
+    Mat scene;
+
+    // To fill a matrix with gaussian noise drawn from the seed of the video and a stream number
+    void fill_noise(Mat &matrix, int stream, double sigma) {
+        RNG rng(this->parameters.seed * 1000003ULL + stream);
+        rng.fill(matrix, RNG::NORMAL, Scalar::all(0.0), Scalar::all(sigma));
+    }
+
+public:
+
+    SynthVideo(const SynthParameters &parameters) : parameters(parameters) {
+        const int width = parameters.width;
+        const int height = parameters.height;
+
+        // Random colors on a coarse grid interpolated to the size of the background
+        Mat coarse(height / 32 + 2, width / 32 + 2, CV_32FC3);
+        RNG rng(parameters.seed);
+        rng.fill(coarse, RNG::UNIFORM, Scalar::all(40.0), Scalar::all(200.0));
+
+        resize(coarse, this->background, Size(width + 2 * SYNTH_MARGIN, height + 2 * SYNTH_MARGIN),
+          0, 0, INTER_CUBIC);
+
+        Mat gain(height, width, CV_32F);
+        Mat moire(height, width, CV_32F);
+        const double pi = 3.14159265358979323846;
+
+        if (parameters.pattern.compare("print") == 0) {
+
+            // Halftone screen at 45 degrees with a period of 5 pixels, and the grain of the paper
+            Mat grain(height, width, CV_32F);
+            fill_noise(grain, -1, 0.04);
+
+            for (int y = 0; y < height; y++) {
+                float *row = gain.ptr<float>(y);
+                const float *grain_row = grain.ptr<float>(y);
+
+                for (int x = 0; x < width; x++) {
+                    row[x] = static_cast<float>(0.85 + 0.15 * cos(2.0 * pi * (x + y) / 5.0) *
+                      cos(2.0 * pi * (x - y) / 5.0)) + grain_row[x];
+                }
+            }
+        } else if (parameters.pattern.compare("replay") == 0) {
+
+            // Pixel grid of the screen slightly rotated and finer than the pixels of the camera,
+            // aliased into a beat of low frequency
+            const double angle = 3.0 * pi / 180.0;
+            const double period = 2.1;
+
+            for (int y = 0; y < height; y++) {
+                float *row = moire.ptr<float>(y);
+
+                for (int x = 0; x < width; x++) {
+                    double u = x * cos(angle) + y * sin(angle);
+                    double v = y * cos(angle) - x * sin(angle);
+
+                    row[x] = static_cast<float>(12.0 * cos(2.0 * pi * u / period) *
+                      cos(2.0 * pi * v / period));
+                }
+            }
+        }
+
+        if (parameters.pattern.compare("print") == 0) {
+            Mat channels[] = { gain, gain, gain };
+            merge(channels, 3, this->gain);
+        } else if (parameters.pattern.compare("replay") == 0) {
+            Mat moire_channels[] = { moire, moire, moire };
+            merge(moire_channels, 3, this->moire);
+        }
+
+        this->noise.create(height, width, CV_32FC3);
+    }
+
+    // To generate the frame of the given index
+    void generate(int index, Mat &frame) {
+        const double pi = 3.14159265358979323846;
+        const double t = index / this->parameters.fps;
+        const int width = this->parameters.width;
+        const int height = this->parameters.height;
+        bool is_print = this->parameters.pattern.compare("print") == 0;
+
+        // The photo shakes as a whole, while the head moves in front of a still background
+        int dx = 0, dy = 0;
+        double head_x = 0.08 * width * sin(2.0 * pi * 0.3 * t);
+        double head_y = 0.04 * height * sin(2.0 * pi * 0.5 * t + 1.0);
+
+        if (is_print) {
+            dx = static_cast<int>(floor(6.0 * sin(2.0 * pi * 1.3 * t) + 0.5));
+            dy = static_cast<int>(floor(4.0 * sin(2.0 * pi * 0.9 * t + 0.5) + 0.5));
+            head_x = 0.0;
+            head_y = 0.0;
+        }
+
+        this->background(Rect(SYNTH_MARGIN + dx, SYNTH_MARGIN + dy, width, height)).copyTo(
+          this->scene);
+
+        Point center(static_cast<int>(width / 2 + head_x + dx),
+          static_cast<int>(height / 2 + head_y + dy));
+        Size axes(width / 8, height / 4);
+
+        ellipse(this->scene, center, axes, 0.0, 0.0, 360.0, Scalar(120.0, 150.0, 190.0), -1);
+        ellipse(this->scene, Point(center.x - axes.width / 3, center.y - axes.height / 3),
+          Size(axes.width / 3, axes.height / 4), 0.0, 0.0, 360.0, Scalar(150.0, 180.0, 220.0), -1);
+
+        if (is_print) {
+
+            // Paper reflects a narrower range than the scene
+            this->scene.convertTo(this->scene, CV_32FC3, 0.8, 20.0);
+        }
+
+        if (!this->gain.empty()) {
+            multiply(this->scene, this->gain, this->scene);
+        }
+
+        if (!this->moire.empty()) {
+            this->scene += this->moire;
+
+            // Backlight flicker rolling down the rows
+            for (int y = 0; y < height; y++) {
+                Mat row = this->scene.row(y);
+                row *= 1.0 + 0.04 * sin(2.0 * pi * (1.5 * y / height - 0.2 * index));
+            }
+        }
+
+        fill_noise(this->noise, index, 2.0);
+        this->scene += this->noise;
+        this->scene.convertTo(frame, CV_8UC3);
+    }
+};
+
+int main(int argc, char** argv) {
+
+    SynthParameters parameters;
+    parameters.output = "";
+    parameters.width = 640;
+    parameters.height = 480;
+    parameters.frames = 100;
+    parameters.fps = 25.0;
+    parameters.codec = "MJPG";
+    parameters.pattern = "genuine";
+    parameters.seed = 1;
+
+    bool is_valid = true;
+
+    for (int i = 1; i < argc; i++) {
+        string argument = string(argv[i]);
+
+        if ((i + 1) >= argc) {
+            is_valid = false;
+        } else if (argument.compare("-output") == 0) {
+            parameters.output = string(argv[++i]);
+        } else if (argument.compare("-resolution") == 0) {
+            is_valid = get_resolution(argv[++i], parameters.width, parameters.height);
+        } else if (argument.compare("-size") == 0) {
+            is_valid = sscanf(argv[++i], "%dx%d", &parameters.width, &parameters.height) == 2;
+        } else if (argument.compare("-frames") == 0) {
+            parameters.frames = atoi(argv[++i]);
+        } else if (argument.compare("-fps") == 0) {
+            parameters.fps = atof(argv[++i]);
+        } else if (argument.compare("-codec") == 0) {
+            parameters.codec = string(argv[++i]);
+        } else if (argument.compare("-pattern") == 0) {
+            parameters.pattern = string(argv[++i]);
+        } else if (argument.compare("-seed") == 0) {
+            parameters.seed = strtoull(argv[++i], NULL, 10);
+        } else {
+            is_valid = false;
+        }
+
+        if (!is_valid) {
+            break;
+        }
+    }
+
+    // The chroma of 4:2:0 needs even sizes
+    if (!is_valid || parameters.output.empty() || parameters.width < 64 ||
+          parameters.height < 64 || parameters.width % 2 != 0 || parameters.height % 2 != 0 ||
+          parameters.frames < 1 || parameters.fps <= 0.0 || parameters.codec.size() != 4 ||
+          (parameters.pattern.compare("genuine") != 0 && parameters.pattern.compare("print") != 0 &&
+          parameters.pattern.compare("replay") != 0)) {
+        cout << "Usage: " << argv[0] << " -output <file> [-resolution 480p|720p|1080p|2160p | ";
+        cout << "-size WxH] [-frames n] [-fps f] [-codec fourcc] ";
+        cout << "[-pattern genuine|print|replay] [-seed s]" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    SynthVideo video(parameters);
+    Y4MWriter y4m_writer;
+    VideoWriter video_writer;
+    bool is_y4m = parameters.output.size() > 4 &&
+      parameters.output.compare(parameters.output.size() - 4, 4, ".y4m") == 0;
+    bool is_opened;
+
+    if (is_y4m) {
+        is_opened = y4m_writer.open(parameters.output, parameters.width, parameters.height,
+          parameters.fps);
+    } else {
+        const string &codec = parameters.codec;
+
+        is_opened = video_writer.open(parameters.output,
+          CV_FOURCC(codec[0], codec[1], codec[2], codec[3]), parameters.fps,
+          Size(parameters.width, parameters.height), true);
+    }
+
+    if (!is_opened) {
+        cout << "Error:main():Could not open " << parameters.output << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    Mat frame;
+
+    for (int i = 0; i < parameters.frames; i++) {
+        video.generate(i, frame);
+
+        if (is_y4m) {
+            if (!y4m_writer.write(frame)) {
+                cout << "Error:main():Could not write " << parameters.output << endl;
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            video_writer.write(frame);
+        }
+    }
+
+    if (is_y4m && !y4m_writer.close()) {
+        cout << "Error:main():Could not write " << parameters.output << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return 0;
+}
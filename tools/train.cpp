@@ -0,0 +1,439 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Training of the linear model used by -score_model (see scorer.h) with a partial least squares
+// regression (see pls.h) on the co-occurrence descriptors of labeled visual rhythms.
+// Usage: VisualRhythmTrain -output <model.txt> [-factors k] [-bins b] [-distance d] [-threads n]
+//   (-images <list> [-image_dir <dir>] | -dataset <file.vrds> -labels <list> |
+//   -videos <list> [options of VisualRhythmAntiSpoofing])
+// The label of a sample is 1 (genuine access) or -1 (attack; 0 is also taken as attack).
+// -images: lines "<label> <image>", or the training lists of Extra/DetectorPLS ("<id> <class>
+//   <image,x,y,width,height>"), where the class real is genuine and the other classes are attacks,
+//   the image is inside <image_dir>/<class> and the rectangle is cropped from it.
+// -dataset: the visual rhythms of a dataset container, with lines "<name> <label>" in -labels.
+// -videos: lines "<label> <video>", whose visual rhythms are computed in memory with the options
+//   of VisualRhythmAntiSpoofing, without writing images.
+// The descriptors of the samples are computed by the threads in parallel, each one with its own
+// decoder and visual rhythm, and the regression splits the samples among the same threads.
+
+#include "dataset.h"
+#include "descriptor.h"
+#include "extraction.h"
+#include "pls.h"
+#include "scorer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+// Sample of the training set
+struct TrainingSample {
+
+    // Image, video or name of the dataset entry
+    string source;
+
+    // Region of the image used (empty means the whole image)
+    Rect crop;
+
+    // 1 for genuine accesses and -1 for attacks
+    float label;
+
+};
+
+// To parse a label, false if it is not 1, -1 or 0
+bool parse_label(const string &text, float &label) {
+    if (text.compare("1") == 0 || text.compare("+1") == 0) {
+        label = 1.0f;
+    } else if (text.compare("-1") == 0 || text.compare("0") == 0) {
+        label = -1.0f;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+// To read a list with lines "<label> <source>" (or "<source> <label>" when the label is second)
+bool read_labeled_list(const string &filename, bool is_label_first,
+  vector<TrainingSample> &samples) {
+
+    ifstream list(filename.c_str());
+    string line;
+
+    if (!list.is_open()) {
+        cout << "Error:read_labeled_list():Could not open " << filename << endl;
+        return false;
+    }
+
+    while (getline(list, line)) {
+        vector<string> fields;
+        split_arguments(line, fields);
+
+        if (fields.empty() || fields[0][0] == '#') {
+            continue;
+        }
+
+        TrainingSample sample;
+
+        if (fields.size() != 2 || !parse_label(fields[is_label_first ? 0 : 1], sample.label)) {
+            cout << "Error:read_labeled_list():Invalid line in " << filename << ": " << line << endl;
+            return false;
+        }
+
+        sample.source = fields[is_label_first ? 1 : 0];
+
+        samples.push_back(sample);
+    }
+
+    return true;
+}
+
+// To read a list of images, with labels or in the format of Extra/DetectorPLS
+bool read_image_list(const string &filename, const string &image_dir,
+  vector<TrainingSample> &samples) {
+
+    ifstream list(filename.c_str());
+    string line;
+
+    if (!list.is_open()) {
+        cout << "Error:read_image_list():Could not open " << filename << endl;
+        return false;
+    }
+
+    while (getline(list, line)) {
+        if (line.find('<') == string::npos) {
+            vector<string> fields;
+            split_arguments(line, fields);
+
+            if (fields.empty() || fields[0][0] == '#') {
+                continue;
+            }
+
+            TrainingSample sample;
+
+            if (fields.size() != 2 || !parse_label(fields[0], sample.label)) {
+                cout << "Error:read_image_list():Invalid line in " << filename << ": " << line;
+                cout << endl;
+                return false;
+            }
+
+            sample.source = image_dir + "/" + fields[1];
+            samples.push_back(sample);
+            continue;
+        }
+
+        // <id> <class> <image,x,y,width,height>, with a single window per line
+        istringstream fields(line);
+        string id, category, window;
+        char name[1024];
+        Rect crop;
+
+        fields >> id >> category;
+        getline(fields, window);
+
+        if (count(window.begin(), window.end(), '<') != 1 ||
+              sscanf(window.c_str(), " <%1023[^,],%d,%d,%d,%d>", name, &crop.x, &crop.y,
+              &crop.width, &crop.height) != 5) {
+            cout << "Error:read_image_list():Invalid line in " << filename << ": " << line << endl;
+            return false;
+        }
+
+        TrainingSample sample;
+        size_t slash = category.find_last_of('/');
+        string class_name = (slash == string::npos) ? category : category.substr(slash + 1);
+
+        sample.source = image_dir + "/" + category + "/" + name;
+        sample.crop = crop;
+        sample.label = (class_name.compare("real") == 0) ? 1.0f : -1.0f;
+        samples.push_back(sample);
+    }
+
+    return true;
+}
+
+// To get the image of a sample from an image file, false if it can not be read
+bool read_image_sample(const TrainingSample &sample, Mat &image) {
+    image = imread(sample.source, 0);
+
+    if (image.empty()) {
+        cout << "Error:read_image_sample():Could not read " << sample.source << endl;
+        return false;
+    }
+
+    if (sample.crop.area() > 0) {
+        Rect crop = sample.crop & Rect(0, 0, image.cols, image.rows);
+        image = image(crop);
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+
+    string output = "";
+    string images = "";
+    string image_dir = ".";
+    string dataset = "";
+    string labels = "";
+    string videos = "";
+    int factors = 10;
+    int bins = 16;
+    int distance = 1;
+    int threads = 1;
+    vector<char*> options(1, argv[0]);
+
+    for (int i = 1; i < argc; i++) {
+        string argument = string(argv[i]);
+
+        if (argument.compare("-output") == 0 && (i + 1) < argc) {
+            output = string(argv[++i]);
+        } else if (argument.compare("-images") == 0 && (i + 1) < argc) {
+            images = string(argv[++i]);
+        } else if (argument.compare("-image_dir") == 0 && (i + 1) < argc) {
+            image_dir = string(argv[++i]);
+        } else if (argument.compare("-dataset") == 0 && (i + 1) < argc) {
+            dataset = string(argv[++i]);
+        } else if (argument.compare("-labels") == 0 && (i + 1) < argc) {
+            labels = string(argv[++i]);
+        } else if (argument.compare("-videos") == 0 && (i + 1) < argc) {
+            videos = string(argv[++i]);
+        } else if (argument.compare("-factors") == 0 && (i + 1) < argc) {
+            factors = atoi(argv[++i]);
+        } else if (argument.compare("-bins") == 0 && (i + 1) < argc) {
+            bins = atoi(argv[++i]);
+        } else if (argument.compare("-distance") == 0 && (i + 1) < argc) {
+            distance = atoi(argv[++i]);
+        } else if (argument.compare("-threads") == 0 && (i + 1) < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            options.push_back(argv[i]);
+        }
+    }
+
+    int sources = !images.empty() + !dataset.empty() + !videos.empty();
+
+    if (output.empty() || sources != 1 || (!dataset.empty() && labels.empty()) ||
+          (videos.empty() && options.size() > 1) || factors < 1 || bins < 1 || bins > 256 ||
+          distance < 1 || threads < 1) {
+        cout << "Usage: " << argv[0] << " -output <model.txt> [-factors k] [-bins b] ";
+        cout << "[-distance d] [-threads n] (-images <list> [-image_dir <dir>] | ";
+        cout << "-dataset <file.vrds> -labels <list> | -videos <list> [options])" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<TrainingSample> samples;
+    bool is_read = true;
+
+    if (!images.empty()) {
+        is_read = read_image_list(images, image_dir, samples);
+    } else if (!dataset.empty()) {
+        is_read = read_labeled_list(labels, false, samples);
+    } else {
+        is_read = read_labeled_list(videos, true, samples);
+    }
+
+    if (!is_read || samples.empty()) {
+        cout << "Error:main():No training samples" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // The options of the videos are verified with the first video of the list
+    Parameters parameters;
+
+    if (!videos.empty()) {
+        if (parse_command_line(static_cast<int>(options.size()), &options[0], parameters)) {
+            exit(EXIT_FAILURE);
+        }
+
+        parameters.input_video = samples[0].source;
+        parameters.output_image = "unused.png";
+
+        if (verify_command_line(parameters)) {
+            exit(EXIT_FAILURE);
+        }
+
+        parameters.verbose = false;
+        parameters.streaming_output = 0;
+        parameters.threads = 1;
+        parameters.score_model = "";
+    }
+
+    ThreadPool thread_pool;
+    thread_pool.start(threads);
+
+    // Descriptors of the samples, one per row, computed by bands of samples
+    const int sample_number = static_cast<int>(samples.size());
+    const int band_number = std::min(sample_number, 2 * threads);
+    Mat features(sample_number, 4 * bins * bins, CV_32F);
+    vector<float> responses(sample_number);
+    vector<int> failures(band_number, 0);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    thread_pool.parallel_for(band_number, [&](int band) {
+        int begin = 0, end = 0;
+        chunk_range(sample_number, band_number, band, begin, end);
+
+        Video processor;
+        VisualRhythm visual_rhythm;
+        DatasetReader reader;
+        map<string, DatasetEntry> entries;
+        vector<char> data;
+        vector<float> descriptor;
+        Mat image;
+
+        if (!videos.empty()) {
+            configure_visual_rhythm(parameters, visual_rhythm);
+        } else if (!dataset.empty()) {
+            if (!reader.open(dataset)) {
+                failures[band] = end - begin;
+                return;
+            }
+
+            for (size_t e = 0; e < reader.get_entries().size(); e++) {
+                entries[reader.get_entries()[e].name] = reader.get_entries()[e];
+            }
+        }
+
+        for (int s = begin; s < end; s++) {
+            const TrainingSample &sample = samples[s];
+            bool is_ok = true;
+
+            if (!images.empty()) {
+                is_ok = read_image_sample(sample, image);
+            } else if (!dataset.empty()) {
+                map<string, DatasetEntry>::iterator it = entries.find(sample.source);
+
+                is_ok = it != entries.end() && reader.read(it->second, data) && !data.empty();
+
+                if (is_ok) {
+                    image = imdecode(Mat(1, static_cast<int>(data.size()), CV_8U, &data[0]), 0);
+                    is_ok = !image.empty();
+                }
+
+                if (!is_ok) {
+                    cout << "Error:main():Could not read " << sample.source << " from ";
+                    cout << dataset << endl;
+                }
+            } else {
+                Parameters video_parameters = parameters;
+                video_parameters.input_video = sample.source;
+                visual_rhythm.reset();
+
+                is_ok = extract_visual_rhythm(video_parameters, processor, visual_rhythm);
+
+                if (is_ok) {
+
+                    // Only the columns of the frames really processed, as seen by the scorer
+                    Mat rhythm = visual_rhythm.get_visual_rhythm();
+                    int cols = std::min(visual_rhythm.get_frame_number() * parameters.roi_width,
+                      rhythm.cols);
+
+                    image = rhythm.colRange(0, cols);
+                    is_ok = cols > 0;
+                }
+
+                if (!is_ok) {
+                    cout << "Error:main():Could not compute the visual rhythm of ";
+                    cout << sample.source << endl;
+                }
+            }
+
+            if (!is_ok) {
+                failures[band]++;
+                continue;
+            }
+
+            compute_glcm_descriptor(image, descriptor, bins, distance);
+            std::copy(descriptor.begin(), descriptor.end(), features.ptr<float>(s));
+            responses[s] = sample.label;
+        }
+    });
+
+    int failure_number = 0;
+
+    for (int b = 0; b < band_number; b++) {
+        failure_number += failures[b];
+    }
+
+    if (failure_number > 0) {
+        cout << "Error:main():" << failure_number << " samples could not be read" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::chrono::duration<double> feature_time = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+
+    PLSRegression pls;
+    pls.set_factor_number(factors);
+    pls.set_thread_pool(&thread_pool);
+
+    if (!pls.fit(features, responses)) {
+        exit(EXIT_FAILURE);
+    }
+
+    std::chrono::duration<double> fit_time = std::chrono::steady_clock::now() - start;
+
+    vector<float> weights;
+    float bias = 0.0f;
+    pls.get_linear_model(weights, bias);
+
+    LinearScorer scorer;
+    scorer.set_model(bins, distance, bias, weights);
+
+    if (!scorer.save(output)) {
+        exit(EXIT_FAILURE);
+    }
+
+    // Training accuracy at the threshold 0
+    int genuine = 0, correct = 0;
+
+    for (int s = 0; s < sample_number; s++) {
+        const float *feature = features.ptr<float>(s);
+        double score = bias;
+
+        for (size_t j = 0; j < weights.size(); j++) {
+            score += weights[j] * feature[j];
+        }
+
+        genuine += (responses[s] > 0.0f);
+        correct += ((score >= 0.0) == (responses[s] > 0.0f));
+    }
+
+    cout << "Samples: " << sample_number << " (" << genuine << " genuine, ";
+    cout << sample_number - genuine << " attacks)" << endl;
+    cout << "Factors: " << pls.get_fitted_factor_number() << endl;
+    cout << "Training accuracy: " << 100.0 * correct / sample_number << "%" << endl;
+    cout << "Time: descriptors " << feature_time.count() << " s, regression ";
+    cout << fit_time.count() << " s" << endl;
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Conversion of a visual rhythm written with -streaming_output 1 (transposed PGM image) to the
+// usual orientation. Usage: VisualRhythmTranspose <input.pgm> <output.png>
+
+#include "visualrhythm.h"
+
+int main(int argc, char** argv) {
+
+    if (argc != 3) {
+        cout << "Usage: " << argv[0] << " <input.pgm> <output.png>" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    Mat streamed = imread(argv[1], 0);
+
+    if (streamed.empty()) {
+        cout << "Error:main():Could not read " << argv[1] << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    Mat visual_rhythm;
+    transpose(streamed, visual_rhythm);
+
+    if (!imwrite(argv[2], visual_rhythm)) {
+        cout << "Error:main():Could not write " << argv[2] << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return 0;
+}
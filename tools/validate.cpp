@@ -0,0 +1,183 @@
+/*------------------------------------------------------------------------------------------------*\
+    Copyright (c) 2015, Allan Pinto, William Robson Schwartz, Helio Pedrini, and Anderson Rocha
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of University of Campinas (Unicamp) nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+\*------------------------------------------------------------------------------------------------*/
+
+// Validation of the approximate fast spectrum (-fast_spectrum 1) against the exact spectrum.
+// Usage: VisualRhythmValidate [options of VisualRhythmAntiSpoofing]
+// For each frame used in the visual rhythm, the noise image is transformed by the exact and the
+// approximate paths and the pixel errors of the 8-bit spectra are reported. Then the visual
+// rhythm is computed by both paths and the co-occurrence descriptors of the two rhythms are
+// compared. With -filter 2, the noise images of the recursive gaussian are also compared with
+// the noise images of the exact gaussian, with a kernel of radius ceil(4 * variance) and the
+// default border of OpenCV. The output image is not written.
+
+#include "descriptor.h"
+#include "extraction.h"
+
+#include <cmath>
+
+// Accumulated differences between two 8-bit images
+struct ErrorStatistics {
+    double max_error;
+    double sum_error;
+    double pixels;
+    double changed_pixels;
+};
+
+void accumulate_error(const Mat &exact, const Mat &approximate, ErrorStatistics &statistics) {
+    Mat difference;
+
+    absdiff(exact, approximate, difference);
+
+    double max_error = 0.0;
+    minMaxLoc(difference, NULL, &max_error);
+
+    statistics.max_error = std::max(statistics.max_error, max_error);
+    statistics.sum_error += sum(difference)[0];
+    statistics.pixels += static_cast<double>(difference.total());
+    statistics.changed_pixels += countNonZero(difference);
+}
+
+void print_error(const string &name, const ErrorStatistics &statistics) {
+    double pixels = std::max(statistics.pixels, 1.0);
+
+    cout << name << ": max abs error " << statistics.max_error;
+    cout << ", mean abs error " << statistics.sum_error / pixels;
+    cout << ", changed pixels " << 100.0 * statistics.changed_pixels / pixels << "%" << endl;
+}
+
+int main(int argc, char** argv) {
+
+    Parameters parameters;
+
+    if (parse_command_line(argc, argv, parameters)) {
+        exit(EXIT_FAILURE);
+    }
+
+    if (parameters.output_image.empty()) {
+        parameters.output_image = "unused.png";
+    }
+
+    if (verify_command_line(parameters)) {
+        exit(EXIT_FAILURE);
+    }
+
+    parameters.verbose = false;
+    parameters.streaming_output = 0;
+
+    // Differences between the spectra of each frame
+    VisualRhythm exact_rhythm;
+    VisualRhythm fast_rhythm;
+    Parameters exact_parameters = parameters;
+    Parameters fast_parameters = parameters;
+
+    exact_parameters.fast_spectrum = 0;
+    fast_parameters.fast_spectrum = 1;
+
+    configure_visual_rhythm(exact_parameters, exact_rhythm);
+    configure_visual_rhythm(fast_parameters, fast_rhythm);
+
+    VideoCapture capture(parameters.input_video);
+
+    if (!capture.isOpened()) {
+        cout << "Error:main():Could not open " << parameters.input_video << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    ErrorStatistics spectrum_error = { 0.0, 0.0, 0.0, 0.0 };
+    ErrorStatistics noise_error = { 0.0, 0.0, 0.0, 0.0 };
+    Mat frame, image, noise, exact_spectrum, fast_spectrum, blurred, exact_noise;
+    int gaussian_size = 2 * static_cast<int>(std::ceil(4.0 * parameters.variance)) + 1;
+    int frames = 0;
+
+    while (frames < parameters.frame_number && capture.read(frame)) {
+        exact_rhythm.convert_color_space(frame, image);
+        exact_rhythm.compute_noise_image(image, noise);
+        exact_rhythm.compute_fourier_spectrum(noise, exact_spectrum);
+        fast_rhythm.compute_fourier_spectrum(noise, fast_spectrum);
+
+        accumulate_error(exact_spectrum, fast_spectrum, spectrum_error);
+
+        if (parameters.filter == 2) {
+            GaussianBlur(image, blurred, Size(gaussian_size, gaussian_size), parameters.variance);
+            subtract(image, blurred, exact_noise);
+            accumulate_error(exact_noise, noise, noise_error);
+        }
+
+        frames++;
+    }
+
+    cout << "Frames: " << frames << endl;
+    print_error("Spectrum", spectrum_error);
+
+    if (parameters.filter == 2) {
+        print_error("Recursive gaussian noise", noise_error);
+    }
+
+    // Differences between the visual rhythms and their descriptors
+    Video exact_video, fast_video;
+
+    if (!extract_visual_rhythm(exact_parameters, exact_video, exact_rhythm) ||
+          !extract_visual_rhythm(fast_parameters, fast_video, fast_rhythm)) {
+        exit(EXIT_FAILURE);
+    }
+
+    Mat exact_image = exact_rhythm.get_visual_rhythm().colRange(0, frames * parameters.roi_width);
+    Mat fast_image = fast_rhythm.get_visual_rhythm().colRange(0, frames * parameters.roi_width);
+
+    ErrorStatistics rhythm_error = { 0.0, 0.0, 0.0, 0.0 };
+    accumulate_error(exact_image, fast_image, rhythm_error);
+    print_error("Visual rhythm", rhythm_error);
+
+    vector<float> exact_descriptor, fast_descriptor;
+    compute_glcm_descriptor(exact_image, exact_descriptor);
+    compute_glcm_descriptor(fast_image, fast_descriptor);
+
+    double distance = 0.0, exact_norm = 0.0, fast_norm = 0.0, dot = 0.0, max_difference = 0.0;
+
+    for (size_t i = 0; i < exact_descriptor.size(); i++) {
+        double difference = exact_descriptor[i] - fast_descriptor[i];
+
+        distance += difference * difference;
+        exact_norm += exact_descriptor[i] * exact_descriptor[i];
+        fast_norm += fast_descriptor[i] * fast_descriptor[i];
+        dot += exact_descriptor[i] * fast_descriptor[i];
+        max_difference = std::max(max_difference, std::fabs(difference));
+    }
+
+    exact_norm = std::sqrt(exact_norm);
+    fast_norm = std::sqrt(fast_norm);
+
+    cout << "Descriptor (co-occurrence, " << exact_descriptor.size() << " values): ";
+    cout << "relative L2 error " << std::sqrt(distance) / std::max(exact_norm, 1e-12);
+    cout << ", max abs difference " << max_difference;
+    cout << ", cosine similarity " << dot / std::max(exact_norm * fast_norm, 1e-12) << endl;
+
+    return 0;
+}